@@ -0,0 +1,505 @@
+/**
+ * @file ht_bench.c
+ * @author Daniel Chung
+ * @brief Microbenchmarks for the hashtable module. Every combination of
+ * table size and key length is run through insert, hit lookup, miss lookup,
+ * mixed and delete workloads, and each result, throughput and the latency
+ * percentiles of a sample of the operations, is printed as one CSV row or
+ * JSON line.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <getopt.h>
+#include "../include/hashtable.h"
+#include "../include/histogram.h"
+#include "../include/workload.h"
+#include "../include/errorcode.h"
+
+/**
+ * @brief Small tables are rebuilt and measured again until every workload has
+ * run at least this many operations, so their timings are not just noise.
+ */
+#define BENCH_MIN_OPS (1 << 20)
+
+/**
+ * @brief Number of distinct keys cycled through by the miss lookup workload.
+ */
+#define BENCH_MISS_KEYS (1 << 20)
+
+/**
+ * @brief Combinations whose keys would take more memory than this are
+ * skipped.
+ */
+#define BENCH_MAX_KEY_BYTES ((size_t)4 << 30)
+
+/**
+ * @brief Share of mixed workload operations that are lookups, in percent.
+ * The rest replace the value of an existing key.
+ */
+#define BENCH_MIXED_READ_PCT 90
+
+/**
+ * @brief On average one lookup, update or delete in this many is timed on its
+ * own for the latency percentiles. Timing every one would add two clock reads
+ * per operation and keep independent lookups from overlapping, skewing the
+ * throughput figures. Samples are drawn at random, so they cannot line up
+ * with anything periodic in the workload.
+ */
+#define BENCH_SAMPLE_EVERY 64
+
+/**
+ * @brief Runs one benchmark operation and times it into a latency histogram.
+ */
+#define BENCH_TIMED(p_hist, call)                                \
+    do                                                           \
+    {                                                            \
+        uint64_t sample_start = ht_now_ns();                     \
+        call;                                                    \
+        hist_record((p_hist), ht_now_ns() - sample_start);       \
+    } while (0)
+
+/**
+ * @brief Runs one benchmark operation, timing it if the sampling generator
+ * picks it.
+ */
+#define BENCH_OP(p_rng, p_hist, call)                            \
+    do                                                           \
+    {                                                            \
+        if (0 == wl_rand(p_rng) % BENCH_SAMPLE_EVERY)            \
+        {                                                        \
+            BENCH_TIMED(p_hist, call);                           \
+        }                                                        \
+        else                                                     \
+        {                                                        \
+            call;                                                \
+        }                                                        \
+    } while (0)
+
+#define BENCH_MAX_PARAMS 16
+
+typedef enum bench_workload_t
+{
+    BENCH_INSERT = 0,
+    BENCH_HIT,
+    BENCH_MISS,
+    BENCH_MIXED,
+    BENCH_DELETE,
+    BENCH_WORKLOAD_COUNT,
+} bench_workload_t;
+
+typedef struct bench_keys_t
+{
+    char *     p_bytes;     // count keys of key_len + 1 bytes each
+    uint32_t * p_order;     // random permutation of 0 .. count - 1
+    size_t     count;
+    size_t     key_len;
+} bench_keys_t;
+
+static const char * gp_workload_names[BENCH_WORKLOAD_COUNT]
+    = { "insert", "hit", "miss", "mixed", "delete" };
+
+static const size_t g_quick_sizes[]    = { 1000, 100000, 1000000 };
+static const size_t g_quick_key_lens[] = { 8, 64 };
+static const size_t g_full_sizes[]
+    = { 1000, 10000, 100000, 1000000, 10000000, 50000000 };
+static const size_t g_full_key_lens[] = { 8, 16, 32, 64, 128, 256 };
+
+static error_t  bench_keys_init (bench_keys_t * p_keys,
+                                 size_t         count,
+                                 size_t         key_len,
+                                 int            miss);
+static void     bench_keys_free (bench_keys_t * p_keys);
+static error_t  bench_run (size_t entries, size_t key_len, int json);
+static size_t   bench_parse_list (char * p_arg, size_t * p_values);
+static void     bench_report (bench_workload_t workload,
+                              size_t           entries,
+                              size_t           key_len,
+                              size_t           ops,
+                              uint64_t         elapsed_ns,
+                              const hist_t *   p_hist,
+                              int              json);
+
+static volatile uintptr_t g_sink = 0;
+
+int main (int argc, char ** argv)
+{
+    size_t sizes[BENCH_MAX_PARAMS];
+    size_t key_lens[BENCH_MAX_PARAMS];
+    size_t size_count    = sizeof(g_quick_sizes) / sizeof(g_quick_sizes[0]);
+    size_t key_len_count = sizeof(g_quick_key_lens) / sizeof(size_t);
+    int    json          = 0;
+    int    opt           = 0;
+
+    memcpy(sizes, g_quick_sizes, sizeof(g_quick_sizes));
+    memcpy(key_lens, g_quick_key_lens, sizeof(g_quick_key_lens));
+
+    while (-1 != (opt = getopt(argc, argv, "fjs:k:h")))
+    {
+        switch (opt)
+        {
+            case 'f':
+                size_count = sizeof(g_full_sizes) / sizeof(g_full_sizes[0]);
+                key_len_count = sizeof(g_full_key_lens) / sizeof(size_t);
+                memcpy(sizes, g_full_sizes, sizeof(g_full_sizes));
+                memcpy(key_lens, g_full_key_lens, sizeof(g_full_key_lens));
+                break;
+            case 'j':
+                json = 1;
+                break;
+            case 's':
+                size_count = bench_parse_list(optarg, sizes);
+                break;
+            case 'k':
+                key_len_count = bench_parse_list(optarg, key_lens);
+                break;
+            default:
+                fprintf(stderr,
+                        "usage: %s [-f] [-j] [-s entries,...] [-k len,...]\n"
+                        "  -f  full sweep, 1K to 50M entries, keys of 8 to "
+                        "256 bytes\n"
+                        "  -j  print JSON lines instead of CSV\n"
+                        "  -s  comma separated table sizes\n"
+                        "  -k  comma separated key lengths, at least 8\n"
+                        "Throughput covers every operation. The latency "
+                        "columns cover the sampled_ops\noperations timed on "
+                        "their own: every insert, and a random 1 in %d of "
+                        "the rest.\n",
+                        argv[0], BENCH_SAMPLE_EVERY);
+                return ('h' == opt ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+    }
+
+    if (!json)
+    {
+        printf("workload,entries,key_len,ops,seconds,ops_per_sec,ns_per_op,"
+               "sampled_ops,p50_ns,p99_ns,p999_ns,max_ns\n");
+    }
+
+    for (size_t size_idx = 0; size_idx < size_count; size_idx++)
+    {
+        for (size_t len_idx = 0; len_idx < key_len_count; len_idx++)
+        {
+            error_t retval
+                = bench_run(sizes[size_idx], key_lens[len_idx], json);
+
+            if (E_SUCCESS != retval)
+            {
+                return (EXIT_FAILURE);
+            }
+        }
+    }
+
+    return (EXIT_SUCCESS);
+}
+
+/**
+ * @brief A private function that runs every workload against one table size
+ * and key length.
+ *
+ * @param entries Number of entries the table is filled with.
+ * @param key_len Length of every key in bytes.
+ * @param json Non zero to report JSON lines instead of CSV rows.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t bench_run (size_t entries, size_t key_len, int json)
+{
+    error_t      retval                        = E_GENERAL;
+    bench_keys_t keys                          = { 0 };
+    bench_keys_t misses                        = { 0 };
+    uint64_t     elapsed[BENCH_WORKLOAD_COUNT] = { 0 };
+    size_t       rounds                        = 1;
+    uint64_t     rng                           = 0x2545F4914F6CDD1D;
+    uint64_t     sample_rng                    = 0x853C49E6748FEA9B;
+    hist_t *     p_hists                       = NULL;
+
+    p_hists = calloc(BENCH_WORKLOAD_COUNT, sizeof(hist_t));
+
+    if (NULL == p_hists)
+    {
+        perror("Failed to calloc memory for latency histograms\n");
+        goto EXIT;
+    }
+
+    for (int workload = 0; workload < BENCH_WORKLOAD_COUNT; workload++)
+    {
+        hist_init(&p_hists[workload]);
+    }
+
+    if (WL_KEY_LEN_MIN > key_len || 0 == entries || UINT32_MAX < entries)
+    {
+        fprintf(stderr, "skipping %zu entries of %zu byte keys\n",
+                entries, key_len);
+        retval = E_SUCCESS;
+        goto EXIT;
+    }
+
+    if (BENCH_MAX_KEY_BYTES / (key_len + 1) < entries)
+    {
+        fprintf(stderr, "skipping %zu entries of %zu byte keys, keys would "
+                "exceed %zu bytes\n", entries, key_len, BENCH_MAX_KEY_BYTES);
+        retval = E_SUCCESS;
+        goto EXIT;
+    }
+
+    if ((E_SUCCESS != bench_keys_init(&keys, entries, key_len, 0))
+        || (E_SUCCESS
+            != bench_keys_init(&misses,
+                               (BENCH_MISS_KEYS < entries) ? BENCH_MISS_KEYS
+                                                           : entries,
+                               key_len,
+                               1)))
+    {
+        goto EXIT;
+    }
+
+    if (BENCH_MIN_OPS > entries)
+    {
+        rounds = BENCH_MIN_OPS / entries;
+    }
+
+    size_t stride = key_len + 1;
+
+    // Throughput covers every operation, latency only the sampled ones.
+    // Inserts run twice: untimed for throughput, then each one timed, since
+    // the few inserts that resize the table are the tail worth seeing and
+    // random sampling would almost always miss them.
+    for (size_t round = 0; round < rounds; round++)
+    {
+        ht_t *   p_ht  = ht_create(0);
+        uint64_t start = 0;
+
+        if (NULL == p_ht)
+        {
+            perror("Failed to create hashtable\n");
+            goto EXIT;
+        }
+
+        start = ht_now_ns();
+        for (size_t op = 0; op < entries; op++)
+        {
+            char * p_key = keys.p_bytes + (size_t)keys.p_order[op] * stride;
+            ht_insert(&p_ht, p_key, p_key);
+        }
+        elapsed[BENCH_INSERT] += ht_now_ns() - start;
+
+        ht_destroy(p_ht);
+        p_ht = ht_create(0);
+
+        if (NULL == p_ht)
+        {
+            perror("Failed to create hashtable\n");
+            goto EXIT;
+        }
+
+        for (size_t op = 0; op < entries; op++)
+        {
+            char * p_key = keys.p_bytes + (size_t)keys.p_order[op] * stride;
+            BENCH_TIMED(&p_hists[BENCH_INSERT],
+                        ht_insert(&p_ht, p_key, p_key));
+        }
+
+        start = ht_now_ns();
+        for (size_t op = 0; op < entries; op++)
+        {
+            char * p_key = keys.p_bytes
+                           + (size_t)keys.p_order[entries - 1 - op] * stride;
+            BENCH_OP(&sample_rng, &p_hists[BENCH_HIT],
+                     g_sink += (uintptr_t)ht_search(p_ht, p_key));
+        }
+        elapsed[BENCH_HIT] += ht_now_ns() - start;
+
+        start = ht_now_ns();
+        for (size_t op = 0; op < entries; op++)
+        {
+            char * p_key = misses.p_bytes
+                           + (size_t)misses.p_order[op % misses.count] * stride;
+            BENCH_OP(&sample_rng, &p_hists[BENCH_MISS],
+                     g_sink += (uintptr_t)ht_search(p_ht, p_key));
+        }
+        elapsed[BENCH_MISS] += ht_now_ns() - start;
+
+        start = ht_now_ns();
+        for (size_t op = 0; op < entries; op++)
+        {
+            uint64_t random = wl_rand(&rng);
+            char *   p_key  = keys.p_bytes + (random % entries) * stride;
+
+            if ((random >> 32) % 100 < BENCH_MIXED_READ_PCT)
+            {
+                BENCH_OP(&sample_rng, &p_hists[BENCH_MIXED],
+                         g_sink += (uintptr_t)ht_search(p_ht, p_key));
+            }
+            else
+            {
+                BENCH_OP(&sample_rng, &p_hists[BENCH_MIXED],
+                         ht_upsert(&p_ht, p_key, p_key));
+            }
+        }
+        elapsed[BENCH_MIXED] += ht_now_ns() - start;
+
+        start = ht_now_ns();
+        for (size_t op = 0; op < entries; op++)
+        {
+            char * p_key = keys.p_bytes + (size_t)keys.p_order[op] * stride;
+            BENCH_OP(&sample_rng, &p_hists[BENCH_DELETE],
+                     ht_delete(p_ht, p_key));
+        }
+        elapsed[BENCH_DELETE] += ht_now_ns() - start;
+
+        ht_destroy(p_ht);
+    }
+
+    for (int workload = 0; workload < BENCH_WORKLOAD_COUNT; workload++)
+    {
+        bench_report((bench_workload_t)workload, entries, key_len,
+                     entries * rounds, elapsed[workload], &p_hists[workload],
+                     json);
+    }
+
+    retval = E_SUCCESS;
+
+EXIT:
+    bench_keys_free(&keys);
+    bench_keys_free(&misses);
+    free(p_hists);
+    return (retval);
+}
+
+/**
+ * @brief A private function that prints the result of one workload.
+ *
+ * @param workload The workload.
+ * @param entries Number of entries in the table.
+ * @param key_len Length of every key in bytes.
+ * @param ops Number of operations run.
+ * @param elapsed_ns Time the operations took in nanoseconds.
+ * @param p_hist Pointer to the latency histogram of the sampled operations,
+ * whose count is reported alongside the percentiles.
+ * @param json Non zero to print a JSON line instead of a CSV row.
+ */
+static void bench_report (bench_workload_t workload,
+                          size_t           entries,
+                          size_t           key_len,
+                          size_t           ops,
+                          uint64_t         elapsed_ns,
+                          const hist_t *   p_hist,
+                          int              json)
+{
+    double       seconds   = (double)elapsed_ns / 1e9;
+    double       ops_per_s = (0 < elapsed_ns) ? (double)ops / seconds : 0;
+    double       ns_per_op = (double)elapsed_ns / (double)ops;
+    const char * p_fmt
+        = json ? "{\"workload\":\"%s\",\"entries\":%zu,\"key_len\":%zu,"
+                 "\"ops\":%zu,\"seconds\":%.6f,\"ops_per_sec\":%.0f,"
+                 "\"ns_per_op\":%.2f,\"sampled_ops\":%llu,"
+                 "\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,"
+                 "\"max_ns\":%llu}\n"
+               : "%s,%zu,%zu,%zu,%.6f,%.0f,%.2f,%llu,%llu,%llu,%llu,%llu\n";
+
+    printf(p_fmt, gp_workload_names[workload], entries, key_len, ops,
+           seconds, ops_per_s, ns_per_op,
+           (unsigned long long)p_hist->count,
+           (unsigned long long)hist_percentile(p_hist, 50),
+           (unsigned long long)hist_percentile(p_hist, 99),
+           (unsigned long long)hist_percentile(p_hist, 99.9),
+           (unsigned long long)p_hist->max);
+    fflush(stdout);
+}
+
+/**
+ * @brief A private function that generates count distinct keys and a random
+ * order to access them in.
+ *
+ * @param p_keys Pointer to the key set to be filled in.
+ * @param count Number of keys.
+ * @param key_len Length of every key in bytes.
+ * @param miss Non zero to generate keys that never collide with the keys
+ * generated with miss set to 0.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t bench_keys_init (bench_keys_t * p_keys,
+                                size_t         count,
+                                size_t         key_len,
+                                int            miss)
+{
+    error_t  retval = E_GENERAL;
+    uint64_t rng    = 0x9E3779B97F4A7C15 ^ count ^ (uint64_t)miss;
+
+    p_keys->count   = count;
+    p_keys->key_len = key_len;
+    p_keys->p_bytes = malloc(count * (key_len + 1));
+    p_keys->p_order = malloc(count * sizeof(uint32_t));
+
+    if (NULL == p_keys->p_bytes || NULL == p_keys->p_order)
+    {
+        perror("Failed to malloc memory for benchmark keys\n");
+        goto EXIT;
+    }
+
+    for (size_t key_idx = 0; key_idx < count; key_idx++)
+    {
+        // bit 41 separates the two sets, all ids stay below 2^32
+        wl_make_key(p_keys->p_bytes + key_idx * (key_len + 1), key_len,
+                    key_idx | ((uint64_t)miss << 41));
+        p_keys->p_order[key_idx] = (uint32_t)key_idx;
+    }
+
+    // Fisher-Yates, so lookups do not walk memory in insertion order
+    for (size_t key_idx = count - 1; 0 < key_idx; key_idx--)
+    {
+        size_t   swap_idx = wl_rand(&rng) % (key_idx + 1);
+        uint32_t temp     = p_keys->p_order[key_idx];
+
+        p_keys->p_order[key_idx]  = p_keys->p_order[swap_idx];
+        p_keys->p_order[swap_idx] = temp;
+    }
+
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that releases a key set.
+ *
+ * @param p_keys Pointer to the key set.
+ */
+static void bench_keys_free (bench_keys_t * p_keys)
+{
+    free(p_keys->p_bytes);
+    free(p_keys->p_order);
+    p_keys->p_bytes = NULL;
+    p_keys->p_order = NULL;
+}
+
+/**
+ * @brief A private function that parses a comma separated list of sizes.
+ *
+ * @param p_arg The list.
+ * @param p_values Array of BENCH_MAX_PARAMS values to be filled in.
+ * @return size_t Number of values parsed.
+ */
+static size_t bench_parse_list (char * p_arg, size_t * p_values)
+{
+    size_t count = 0;
+
+    for (char * p_token = strtok(p_arg, ",");
+         (NULL != p_token) && (BENCH_MAX_PARAMS > count);
+         p_token = strtok(NULL, ","))
+    {
+        p_values[count++] = strtoull(p_token, NULL, 10);
+    }
+
+    return (count);
+}
+
+/*** end of file ***/
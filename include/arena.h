@@ -0,0 +1,56 @@
+/**
+ * @file arena.h
+ * @author Daniel Chung
+ * @brief Header file for the variable size arena allocator module.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "errorcode.h"
+
+#ifndef ARENA_H
+#define ARENA_H
+
+/**
+ * @brief Size of the chunks small allocations are carved from.
+ */
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+/**
+ * @brief Small allocations are rounded up to a multiple of the granule and
+ * recycled through one free list per rounded size. Anything larger than
+ * ARENA_GRANULE * ARENA_CLASS_COUNT bytes gets its own heap allocation.
+ */
+#define ARENA_GRANULE     16
+#define ARENA_CLASS_COUNT 32
+
+typedef struct arena_chunk_t
+{
+    struct arena_chunk_t * p_next;
+    struct arena_chunk_t * p_prev; // only used by large allocations
+    size_t                 size;   // bytes, including this header
+} arena_chunk_t;
+
+typedef struct arena_t
+{
+    arena_chunk_t * p_chunks;
+    arena_chunk_t * p_large; // doubly linked, so one can be freed alone
+    char *          p_bump;
+    char *          p_bump_end;
+    void *          p_free[ARENA_CLASS_COUNT];
+    size_t          chunk_bytes; // total bytes held, chunks and large
+} arena_t;
+
+void   arena_init (arena_t * p_arena);
+void * arena_alloc (arena_t * p_arena, size_t size);
+void   arena_free (arena_t * p_arena, void * p_ptr, size_t size);
+void   arena_destroy (arena_t * p_arena);
+
+#endif // ARENA_H
+
+/*** end of arena.h ***/
@@ -0,0 +1,100 @@
+/**
+ * @file concurrent_hashtable.h
+ * @author Daniel Chung
+ * @brief Header file for the thread safe, lock striped hashtable module with
+ * lock free readers.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+#include "errorcode.h"
+
+#ifndef CONCURRENT_HASHTABLE_H
+#define CONCURRENT_HASHTABLE_H
+
+/**
+ * @brief Number of segments used when cht_create() is given 0.
+ */
+#define CHT_DEFAULT_SEGMENTS 64
+
+/**
+ * @brief Initial bucket count of every segment.
+ */
+#define CHT_SEGMENT_BUCKETS 16
+
+/**
+ * @brief Callback of cht_update_with(), run under the key's segment lock. It
+ * receives a private copy of the stored value, which it may read and
+ * overwrite, and whether the entry was just created with a NULL value.
+ */
+typedef void (*cht_update_fn_t) (void ** pp_value, int created, void * p_ctx);
+
+/**
+ * @brief A chain node. Readers follow p_next and load p_value without any
+ * lock, so both are atomic; p_key and hash never change once published.
+ */
+typedef struct cht_node_t
+{
+    char *                       p_key;
+    _Atomic(void *)              p_value;
+    _Atomic(struct cht_node_t *) p_next;
+    uint32_t                     hash;
+} cht_node_t;
+
+/**
+ * @brief A bucket array together with its size, published as one pointer so
+ * a reader always indexes an array with the capacity it was built for.
+ */
+typedef struct cht_table_t
+{
+    size_t                capacity; // always a power of two
+    _Atomic(cht_node_t *) pp_items[];
+} cht_table_t;
+
+/**
+ * @brief An independent chained table guarding its own buckets. Writers
+ * serialize on the segment mutex; readers take no lock at all and rely on
+ * epoch based reclamation to keep unlinked nodes and tables alive. Each
+ * segment is cache line aligned so that locking one never bounces the line
+ * holding its neighbour.
+ */
+typedef struct cht_segment_t
+{
+    _Alignas(64) pthread_mutex_t lock;
+    _Atomic(cht_table_t *) p_table;
+    size_t                 size; // number of entries, guarded by lock
+} cht_segment_t;
+
+/**
+ * @brief A hashtable that can be shared between threads. The top bits of a
+ * key's hash pick one of segment_count segments and the low bits pick the
+ * bucket inside it. Writes to different segments never contend, a segment
+ * grows under its own lock only, and searches never lock.
+ */
+typedef struct cht_t
+{
+    cht_segment_t * p_segments;
+    size_t          segment_count; // always a power of two
+    uint32_t        segment_shift; // 32 - log2(segment_count)
+} cht_t;
+
+cht_t * cht_create (size_t segment_count);
+error_t cht_destroy (cht_t * p_cht);
+error_t cht_insert (cht_t * p_cht, char * p_key, void * p_value);
+error_t cht_delete (cht_t * p_cht, char * p_key);
+void *  cht_search (cht_t * p_cht, char * p_key);
+error_t cht_update_with (cht_t *         p_cht,
+                         char *          p_key,
+                         cht_update_fn_t update_fn,
+                         void *          p_ctx);
+
+#endif // CONCURRENT_HASHTABLE_H
+
+/*** end of concurrent_hashtable.h ***/
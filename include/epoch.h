@@ -0,0 +1,38 @@
+/**
+ * @file epoch.h
+ * @author Daniel Chung
+ * @brief Header file for the epoch based memory reclamation module.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+
+#ifndef EPOCH_H
+#define EPOCH_H
+
+/**
+ * @brief Number of retirements a thread makes between attempts to advance
+ * the global epoch and free its old garbage.
+ */
+#define EPOCH_RETIRE_BATCH 64
+
+typedef void (*epoch_free_fn) (void * p_ptr);
+
+/**
+ * Readers bracket every access to shared nodes with epoch_enter() and
+ * epoch_exit(). Writers that unlink a node hand it to epoch_retire() instead
+ * of freeing it; the node is released once every thread has left the
+ * critical sections that could still see it. Sections may nest.
+ */
+void epoch_enter (void);
+void epoch_exit (void);
+void epoch_retire (void * p_ptr, epoch_free_fn free_fn);
+void epoch_drain (void);
+
+#endif // EPOCH_H
+
+/*** end of epoch.h ***/
@@ -23,6 +23,8 @@ enum error_t
     E_HASHTABLE_DELETE,
     E_HASHTABLE_DESTROY,
     E_NODE_NOT_FOUND,
+    E_KEY_EXISTS,
+    E_NOT_SUPPORTED,
 };
 
 typedef enum error_t error_t;
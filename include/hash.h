@@ -0,0 +1,31 @@
+/**
+ * @file hash.h
+ * @author Daniel Chung
+ * @brief Header file for the hash functions shared by the hashtables.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef HASH_H
+#define HASH_H
+
+/**
+ * @brief Signature of a pluggable hash function. Tables that take one fold
+ * the 64 bit result down to the width they store.
+ */
+typedef uint64_t (*hash_fn_t) (const void * p_key, size_t len, uint64_t seed);
+
+uint32_t murmurhash (const void * p_key, int len, uint32_t seed);
+uint64_t hash_murmur3 (const void * p_key, size_t len, uint64_t seed);
+uint64_t hash_wy64 (const void * p_key, size_t len, uint64_t seed);
+uint64_t hash_crc32c (const void * p_key, size_t len, uint64_t seed);
+
+#endif // HASH_H
+
+/*** end of hash.h ***/
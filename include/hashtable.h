@@ -12,6 +12,9 @@
 #include <stdint.h>
 #include <sys/types.h>
 #include "errorcode.h"
+#include "pool.h"
+#include "arena.h"
+#include "hash.h"
 
 #ifndef HASHTABLE_H
 #define HASHTABLE_H
@@ -21,21 +24,276 @@ typedef struct node_t
     char *          p_key;
     void *          p_value;
     struct node_t * p_next;
+    uint32_t        hash;         // cached, folded hash of p_key
+    uint32_t        key_len;      // key length in bytes, without terminator
+    char            key_inline[]; // owned short keys, see HT_KEYS_OWNED
 } node_t;
 
+/**
+ * @brief Longest key accepted, in bytes.
+ */
+#define HT_KEY_LEN_MAX INT32_MAX
+
+/**
+ * @brief Size of a node in a table that owns its keys. Keys that fit in the
+ * rest of the node, terminator included, are stored inline so a lookup reads
+ * them from the node's own cache line.
+ */
+#define HT_OWNED_NODE_SIZE 64
+#define HT_INLINE_KEY_MAX  (HT_OWNED_NODE_SIZE - sizeof(node_t))
+
+/**
+ * @brief Default maximum load factor, in entries per bucket, above which the
+ * hashtable grows to the next size class.
+ */
+#define HT_MAX_LOAD 0.8
+
+/**
+ * @brief A delete shrinks the hashtable once its load factor falls below the
+ * maximum divided by this. The gap keeps a table hovering around one size
+ * from growing and shrinking over and over.
+ */
+#define HT_SHRINK_DIVISOR 4
+
+/**
+ * @brief Number of entries in g_primes, the bucket counts a table can have.
+ */
+#define HT_PRIME_COUNT 26
+
+extern uint32_t g_primes[HT_PRIME_COUNT];
+
+/**
+ * @brief Number of old buckets moved into the new bucket array by every
+ * insert, search and delete while an incremental resize is in progress.
+ */
+#define HT_MIGRATE_STEP 64
+
+/**
+ * @brief Number of keys ht_search_batch() keeps in flight at once. Each of
+ * them has a bucket and then a node prefetch outstanding, so this is sized to
+ * roughly match the line fill buffers of current cores.
+ */
+#define HT_BATCH_CHUNK 16
+
+/**
+ * @brief How the hashtable grows once the load factor is exceeded, and
+ * shrinks once deletes leave it sparse.
+ *
+ * HT_RESIZE_FULL rebuilds the whole table inside the insert or delete that
+ * crossed the threshold. HT_RESIZE_INCREMENTAL allocates the new bucket array
+ * and then moves HT_MIGRATE_STEP old buckets per operation, so no single call
+ * pays for the whole rehash.
+ */
+typedef enum ht_resize_t
+{
+    HT_RESIZE_FULL = 0,
+    HT_RESIZE_INCREMENTAL,
+} ht_resize_t;
+
+/**
+ * @brief How bucket counts are chosen and how a hash is reduced to a bucket.
+ *
+ * HT_CAPACITY_PRIME uses the g_primes sizes and reduces with a precomputed
+ * multiply (Lemire's fastmod) instead of an integer division.
+ * HT_CAPACITY_POW2 uses 64 << prime_index buckets and picks the bucket from
+ * the top bits of a Fibonacci multiply, so all hash bits take part.
+ */
+typedef enum ht_capacity_t
+{
+    HT_CAPACITY_PRIME = 0,
+    HT_CAPACITY_POW2,
+} ht_capacity_t;
+
+/**
+ * @brief Who keeps the keys alive.
+ *
+ * HT_KEYS_BORROWED stores the caller's key pointer, which must outlive the
+ * entry. HT_KEYS_OWNED copies every key into the table: inline in the node
+ * when it fits in HT_INLINE_KEY_MAX bytes, else into the table's key arena.
+ */
+typedef enum ht_keys_t
+{
+    HT_KEYS_BORROWED = 0,
+    HT_KEYS_OWNED,
+} ht_keys_t;
+
+typedef struct ht_opts_t
+{
+    int           prime_index; // size class index for either policy
+    ht_resize_t   resize_mode;
+    ht_capacity_t capacity_policy;
+    ht_keys_t     key_mode;
+    hash_fn_t     hash_fn;   // NULL selects hash_murmur3
+    uint64_t      hash_seed;
+    size_t        expected_entries; // 0, or a count to size the table for
+    double        max_load_factor;  // 0 selects HT_MAX_LOAD
+    uint32_t      metrics_sample_every; // time 1 in N operations, 0 for none
+} ht_opts_t;
+
+/**
+ * @brief Number of entries in ht_stats_t's chain length histogram.
+ * chain_lengths[i] counts the buckets whose chain holds i nodes, so slot 0
+ * counts empty buckets, and the last slot counts every chain of
+ * HT_STATS_CHAIN_SLOTS - 1 nodes or more.
+ */
+#define HT_STATS_CHAIN_SLOTS 16
+
+/**
+ * @brief A snapshot of a hashtable's shape and memory use, see ht_stats().
+ * Chain figures cover both bucket arrays while an incremental resize is in
+ * flight.
+ */
+typedef struct ht_stats_t
+{
+    size_t   entries;
+    size_t   used_buckets;
+    size_t   capacity;        // buckets of the active array
+    size_t   old_capacity;    // buckets of the array being drained, or 0
+    double   load_factor;     // entries per active bucket
+    size_t   max_chain;
+    double   mean_chain;      // over occupied buckets
+    double   mean_hit_probes; // nodes visited by a successful lookup
+    size_t   chain_lengths[HT_STATS_CHAIN_SLOTS]; // buckets per chain length
+    size_t   bucket_bytes;
+    size_t   node_bytes;      // node pool blocks
+    size_t   key_bytes;       // key arena chunks, owned keys only
+    uint64_t resize_count;
+    uint64_t resize_ns;       // cumulative, incremental steps included
+} ht_stats_t;
+
+/**
+ * @brief Operation counters kept by tables built with HT_ENABLE_METRICS
+ * (make METRICS=1). Without it the counters and every hook updating them
+ * are compiled out. Every path that links a new entry counts an insert,
+ * bulk loads included, and hits, misses and chain steps cover batched
+ * lookups and the insert-or-update calls as well as ht_search(); an
+ * insert-or-update that finds its key counts a hit.
+ */
+typedef enum ht_metric_t
+{
+    HT_METRIC_INSERTS = 0,
+    HT_METRIC_HITS,
+    HT_METRIC_MISSES,
+    HT_METRIC_DELETES,
+    HT_METRIC_DELETE_MISSES,
+    HT_METRIC_CHAIN_STEPS, // nodes visited by searches and deletes
+    HT_METRIC_RESIZES,
+    HT_METRIC_COUNT,
+} ht_metric_t;
+
+/**
+ * @brief Operations whose latency is sampled, see metrics_sample_every.
+ */
+typedef enum ht_sample_op_t
+{
+    HT_SAMPLE_INSERT = 0,
+    HT_SAMPLE_SEARCH,
+    HT_SAMPLE_DELETE,
+    HT_SAMPLE_OP_COUNT,
+} ht_sample_op_t;
+
+/**
+ * @brief Number of counter shards per table. Each thread updates the shard
+ * it was assigned on first use, so threads rarely share a cache line.
+ */
+#define HT_METRICS_SHARDS 16
+
+typedef struct ht_metrics_t
+{
+    uint64_t counters[HT_METRIC_COUNT];
+    uint64_t samples[HT_SAMPLE_OP_COUNT];
+    uint64_t sample_ns[HT_SAMPLE_OP_COUNT];     // sum of sampled latencies
+    uint64_t sample_max_ns[HT_SAMPLE_OP_COUNT];
+} ht_metrics_t;
+
+#ifdef HT_ENABLE_METRICS
+typedef struct ht_metrics_shard_t
+{
+    _Alignas(64) _Atomic uint64_t counters[HT_METRIC_COUNT];
+    _Atomic uint64_t samples[HT_SAMPLE_OP_COUNT];
+    _Atomic uint64_t sample_ns[HT_SAMPLE_OP_COUNT];
+    _Atomic uint64_t sample_max_ns[HT_SAMPLE_OP_COUNT];
+} ht_metrics_shard_t;
+#endif
+
+/**
+ * @brief Callback of ht_update_with(). It receives a pointer to the stored
+ * value, which it may read and overwrite, and whether the entry was just
+ * created with a NULL value.
+ */
+typedef void (*ht_update_fn_t) (void ** pp_value, int created, void * p_ctx);
+
+/**
+ * @brief A key/value pair handed to ht_bulk_load().
+ */
+typedef struct ht_kv_t
+{
+    char * p_key;
+    void * p_value;
+} ht_kv_t;
+
 typedef struct ht_t
 {
-    node_t ** pp_items;
-    size_t    capacity;
-    size_t    size;
-    uint32_t  prime_index;
+    node_t **     pp_items;
+    size_t        capacity;
+    size_t        size;          // number of entries
+    size_t        used_buckets;  // occupied buckets, in both arrays
+    double        max_load_factor;
+    uint32_t      prime_index;
+    uint32_t      min_index;     // auto-shrink floor, see ht_shrink_to_fit()
+    ht_resize_t   resize_mode;
+    ht_capacity_t capacity_policy;
+    ht_keys_t     key_mode;
+    hash_fn_t     hash_fn;
+    uint64_t      hash_seed;
+    uint64_t      fastmod_m;     // reciprocal of capacity for prime sizes
+    node_t **     pp_old_items;  // bucket array being drained, NULL if none
+    size_t        old_capacity;
+    uint64_t      old_fastmod_m;
+    size_t        migrate_index; // next old bucket to be moved
+    pool_t        node_pool;     // owns every node_t of the table
+    arena_t       key_arena;     // owned keys too long to be inline
+    uint64_t      resize_count;
+    uint64_t      resize_ns;     // time spent resizing, in nanoseconds
+#ifdef HT_ENABLE_METRICS
+    ht_metrics_shard_t * p_metrics; // HT_METRICS_SHARDS shards
+    uint32_t             metrics_sample_every;
+#endif
 } ht_t;
 
 ht_t *  ht_create (int prime_index);
+ht_t *  ht_create_opts (const ht_opts_t * p_opts);
+ht_t *  ht_create_reserve (size_t expected_entries);
+error_t ht_reserve (ht_t * p_ht, size_t expected_entries);
+error_t ht_shrink_to_fit (ht_t * p_ht);
+error_t ht_stats (ht_t * p_ht, ht_stats_t * p_stats);
+error_t ht_metrics (ht_t * p_ht, ht_metrics_t * p_metrics);
 error_t ht_destroy (ht_t * p_ht);
 error_t ht_insert (ht_t ** pp_ht, char * p_key, void * p_value);
+error_t ht_upsert (ht_t ** pp_ht, char * p_key, void * p_value);
+error_t ht_insert_if_absent (ht_t ** pp_ht, char * p_key, void * p_value);
+error_t ht_get_or_insert (ht_t ** pp_ht,
+                          char *   p_key,
+                          void *   p_value,
+                          void **  pp_stored);
+error_t ht_update_with (ht_t **        pp_ht,
+                        char *         p_key,
+                        ht_update_fn_t update_fn,
+                        void *         p_ctx);
 error_t ht_delete (ht_t * p_ht, char * p_key);
 void *  ht_search (ht_t * p_ht, char * p_key);
+error_t ht_insert_n (ht_t **      pp_ht,
+                     const void * p_key,
+                     size_t       key_len,
+                     void *       p_value);
+error_t ht_delete_n (ht_t * p_ht, const void * p_key, size_t key_len);
+void *  ht_search_n (ht_t * p_ht, const void * p_key, size_t key_len);
+error_t ht_search_batch (ht_t *  p_ht,
+                         char ** pp_keys,
+                         size_t  count,
+                         void ** pp_values);
+error_t ht_bulk_load (ht_t ** pp_ht, const ht_kv_t * p_pairs, size_t count);
+uint64_t ht_now_ns (void);
 
 #endif // HASHTABLE_H
 
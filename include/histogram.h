@@ -0,0 +1,50 @@
+/**
+ * @file histogram.h
+ * @author Daniel Chung
+ * @brief Header file for the high dynamic range histogram module.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+/**
+ * @brief Values below 2^HIST_SUB_BITS are counted exactly. Every power of two
+ * above that is split into 2^(HIST_SUB_BITS - 1) equal buckets, so a
+ * recorded value is off by less than 1 / 64 of itself anywhere in the 64 bit
+ * range.
+ */
+#define HIST_SUB_BITS     7
+#define HIST_SUB_COUNT    (1 << HIST_SUB_BITS)
+#define HIST_HALF_COUNT   (HIST_SUB_COUNT / 2)
+#define HIST_BUCKET_COUNT ((64 - HIST_SUB_BITS + 2) * HIST_HALF_COUNT)
+
+/**
+ * @brief A log linear histogram of 64 bit values, typically latencies in
+ * nanoseconds. Recording is a few shifts and an increment; min, max and sum
+ * are kept exactly.
+ */
+typedef struct hist_t
+{
+    uint64_t counts[HIST_BUCKET_COUNT];
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+} hist_t;
+
+void     hist_init (hist_t * p_hist);
+void     hist_record (hist_t * p_hist, uint64_t value);
+void     hist_merge (hist_t * p_dst, const hist_t * p_src);
+uint64_t hist_percentile (const hist_t * p_hist, double percentile);
+
+#endif // HISTOGRAM_H
+
+/*** end of histogram.h ***/
@@ -0,0 +1,52 @@
+/**
+ * @file oa_hashtable.h
+ * @author Daniel Chung
+ * @brief Header file for the open addressing (Robin Hood) hashtable module.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "errorcode.h"
+
+#ifndef OA_HASHTABLE_H
+#define OA_HASHTABLE_H
+
+/**
+ * @brief Load factor above which the slot array is grown to the next prime.
+ */
+#define OA_HT_MAX_LOAD 0.8
+
+/**
+ * @brief A single slot of the flat slot array. dist is the probe distance of
+ * the entry from its home slot plus one, so a zeroed slot is empty.
+ */
+typedef struct oa_slot_t
+{
+    char *   p_key;
+    void *   p_value;
+    uint32_t hash;
+    uint32_t dist;
+} oa_slot_t;
+
+typedef struct oa_ht_t
+{
+    oa_slot_t * p_slots;
+    size_t      capacity;
+    size_t      size;
+    uint32_t    prime_index;
+} oa_ht_t;
+
+oa_ht_t * oa_ht_create (int prime_index);
+error_t   oa_ht_destroy (oa_ht_t * p_ht);
+error_t   oa_ht_insert (oa_ht_t ** pp_ht, char * p_key, void * p_value);
+error_t   oa_ht_delete (oa_ht_t * p_ht, char * p_key);
+void *    oa_ht_search (oa_ht_t * p_ht, char * p_key);
+
+#endif // OA_HASHTABLE_H
+
+/*** end of oa_hashtable.h ***/
@@ -0,0 +1,55 @@
+/**
+ * @file pool.h
+ * @author Daniel Chung
+ * @brief Header file for the fixed size object pool module.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "errorcode.h"
+
+#ifndef POOL_H
+#define POOL_H
+
+/**
+ * @brief Object counts of the first and the largest block. Every new block
+ * holds twice as many objects as the previous one, up to the maximum.
+ */
+#define POOL_MIN_BLOCK_OBJS 64
+#define POOL_MAX_BLOCK_OBJS (1 << 20)
+
+typedef struct pool_block_t
+{
+    struct pool_block_t * p_next;
+    size_t                size; // bytes, including this header
+} pool_block_t;
+
+/**
+ * @brief Carves equally sized objects out of large blocks. Freed objects are
+ * pushed onto an intrusive free list and handed out again before new space
+ * is carved; memory only goes back to the system in pool_destroy().
+ */
+typedef struct pool_t
+{
+    pool_block_t * p_blocks;
+    void *         p_free;      // free list threaded through freed objects
+    char *         p_bump;      // next never used object in the newest block
+    char *         p_bump_end;
+    size_t         obj_size;
+    size_t         block_objs;  // object count of the next block
+    size_t         block_bytes; // total bytes of all blocks
+} pool_t;
+
+error_t pool_init (pool_t * p_pool, size_t obj_size);
+void *  pool_alloc (pool_t * p_pool);
+void    pool_free (pool_t * p_pool, void * p_obj);
+void    pool_destroy (pool_t * p_pool);
+
+#endif // POOL_H
+
+/*** end of pool.h ***/
@@ -0,0 +1,57 @@
+/**
+ * @file swiss_hashtable.h
+ * @author Daniel Chung
+ * @brief Header file for the group probing (SwissTable style) hashtable
+ * module.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "errorcode.h"
+
+#ifndef SWISS_HASHTABLE_H
+#define SWISS_HASHTABLE_H
+
+/**
+ * @brief Number of control bytes matched at once. The slot array is split
+ * into groups of this many slots.
+ */
+#define SW_GROUP_WIDTH 16
+
+/**
+ * @brief Control byte values. A full slot stores the low 7 bits of its hash,
+ * so the high bit marks the two special states.
+ */
+#define SW_CTRL_EMPTY   ((int8_t)-128)
+#define SW_CTRL_DELETED ((int8_t)-2)
+
+typedef struct sw_slot_t
+{
+    char *   p_key;
+    void *   p_value;
+    uint32_t hash;
+} sw_slot_t;
+
+typedef struct sw_ht_t
+{
+    int8_t *    p_ctrl;
+    sw_slot_t * p_slots;
+    size_t      capacity;   // always a multiple of SW_GROUP_WIDTH
+    size_t      size;
+    size_t      tombstones; // slots marked SW_CTRL_DELETED
+} sw_ht_t;
+
+sw_ht_t * sw_ht_create (int prime_index);
+error_t   sw_ht_destroy (sw_ht_t * p_ht);
+error_t   sw_ht_insert (sw_ht_t ** pp_ht, char * p_key, void * p_value);
+error_t   sw_ht_delete (sw_ht_t * p_ht, char * p_key);
+void *    sw_ht_search (sw_ht_t * p_ht, char * p_key);
+
+#endif // SWISS_HASHTABLE_H
+
+/*** end of swiss_hashtable.h ***/
@@ -0,0 +1,52 @@
+/**
+ * @file u64_hashtable.h
+ * @author Daniel Chung
+ * @brief Header file for the 64 bit integer keyed hashtable module.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "errorcode.h"
+
+#ifndef U64_HASHTABLE_H
+#define U64_HASHTABLE_H
+
+/**
+ * @brief Load factor above which the slot array doubles.
+ */
+#define U64_HT_MAX_LOAD 0.75
+
+/**
+ * @brief A slot of the flat slot array. Key 0 marks an empty slot, so an
+ * entry for key 0 is kept outside the array.
+ */
+typedef struct u64_slot_t
+{
+    uint64_t key;
+    void *   p_value;
+} u64_slot_t;
+
+typedef struct u64_ht_t
+{
+    u64_slot_t * p_slots;
+    size_t       capacity; // always a power of two
+    size_t       size;
+    uint32_t     shift;    // 64 - log2(capacity)
+    int          has_zero_key;
+    void *       p_zero_value;
+} u64_ht_t;
+
+u64_ht_t * u64_ht_create (int size_index);
+error_t    u64_ht_destroy (u64_ht_t * p_ht);
+error_t    u64_ht_insert (u64_ht_t ** pp_ht, uint64_t key, void * p_value);
+error_t    u64_ht_delete (u64_ht_t * p_ht, uint64_t key);
+void *     u64_ht_search (u64_ht_t * p_ht, uint64_t key);
+
+#endif // U64_HASHTABLE_H
+
+/*** end of u64_hashtable.h ***/
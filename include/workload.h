@@ -0,0 +1,77 @@
+/**
+ * @file workload.h
+ * @author Daniel Chung
+ * @brief Header file for the workload generation module: random numbers, key
+ * naming and YCSB style key distributions.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "errorcode.h"
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+/**
+ * @brief Default skew of the zipfian distributions, as used by YCSB.
+ */
+#define WL_ZIPF_THETA 0.99
+
+/**
+ * @brief Shortest key wl_make_key() can produce. The key id is written as
+ * this many base 64 digits.
+ */
+#define WL_KEY_LEN_MIN 8
+
+/**
+ * @brief How the key of a read, update or delete is picked among the keys
+ * loaded or inserted so far. WL_DIST_ZIPFIAN makes a few keys hot and
+ * scatters them over the key space (YCSB's scrambled zipfian).
+ * WL_DIST_LATEST makes the most recently inserted keys the hottest.
+ */
+typedef enum wl_dist_t
+{
+    WL_DIST_UNIFORM = 0,
+    WL_DIST_ZIPFIAN,
+    WL_DIST_LATEST,
+} wl_dist_t;
+
+/**
+ * @brief Precomputed constants of a zipfian distribution over item_count
+ * items, following Gray et al., "Quickly Generating Billion-Record Synthetic
+ * Databases".
+ */
+typedef struct wl_zipf_t
+{
+    uint64_t item_count;
+    double   theta;
+    double   alpha;
+    double   zetan;
+    double   eta;
+} wl_zipf_t;
+
+typedef struct wl_keygen_t
+{
+    wl_dist_t dist;
+    wl_zipf_t zipf;
+} wl_keygen_t;
+
+uint64_t wl_rand (uint64_t * p_state);
+double   wl_rand_unit (uint64_t * p_state);
+error_t  wl_keygen_init (wl_keygen_t * p_gen,
+                         wl_dist_t     dist,
+                         uint64_t      item_count,
+                         double        theta);
+uint64_t wl_keygen_next (const wl_keygen_t * p_gen,
+                         uint64_t *          p_rng,
+                         uint64_t            key_count);
+void     wl_make_key (char * p_key, size_t key_len, uint64_t id);
+
+#endif // WORKLOAD_H
+
+/*** end of workload.h ***/
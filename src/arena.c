@@ -0,0 +1,190 @@
+/**
+ * @file arena.c
+ * @author Daniel Chung
+ * @brief An arena allocator for variable sized data such as owned keys.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/arena.h"
+
+/**
+ * @brief Size of a chunk header, padded so the data after it stays aligned.
+ */
+#define ARENA_HEADER_SIZE \
+    ((sizeof(arena_chunk_t) + ARENA_GRANULE - 1) & ~(size_t)(ARENA_GRANULE - 1))
+
+/**
+ * @brief Initializes an empty arena.
+ *
+ * @param p_arena Pointer to the arena.
+ */
+void arena_init (arena_t * p_arena)
+{
+    p_arena->p_chunks    = NULL;
+    p_arena->p_large     = NULL;
+    p_arena->p_bump      = NULL;
+    p_arena->p_bump_end  = NULL;
+    p_arena->chunk_bytes = 0;
+
+    for (uint32_t class_idx = 0; class_idx < ARENA_CLASS_COUNT; class_idx++)
+    {
+        p_arena->p_free[class_idx] = NULL;
+    }
+}
+
+/**
+ * @brief Allocates size bytes, aligned to ARENA_GRANULE.
+ *
+ * @param p_arena Pointer to the arena.
+ * @param size Number of bytes.
+ * @return void* On success, returns a pointer to the memory, else NULL.
+ */
+void * arena_alloc (arena_t * p_arena, size_t size)
+{
+    void * p_ptr = NULL;
+
+    if (0 == size)
+    {
+        size = 1;
+    }
+
+    size_t class_idx = (size - 1) / ARENA_GRANULE;
+
+    if (ARENA_CLASS_COUNT <= class_idx)
+    {
+        arena_chunk_t * p_chunk = malloc(ARENA_HEADER_SIZE + size);
+
+        if (NULL == p_chunk)
+        {
+            perror("Failed to malloc memory for arena allocation\n");
+            goto EXIT;
+        }
+
+        p_chunk->size   = ARENA_HEADER_SIZE + size;
+        p_chunk->p_prev = NULL;
+        p_chunk->p_next = p_arena->p_large;
+
+        if (NULL != p_arena->p_large)
+        {
+            p_arena->p_large->p_prev = p_chunk;
+        }
+
+        p_arena->p_large      = p_chunk;
+        p_arena->chunk_bytes += p_chunk->size;
+        p_ptr                 = (char *)p_chunk + ARENA_HEADER_SIZE;
+        goto EXIT;
+    }
+
+    if (NULL != p_arena->p_free[class_idx])
+    {
+        p_ptr                      = p_arena->p_free[class_idx];
+        p_arena->p_free[class_idx] = *(void **)p_ptr;
+        goto EXIT;
+    }
+
+    size_t rounded = (class_idx + 1) * ARENA_GRANULE;
+
+    if ((size_t)(p_arena->p_bump_end - p_arena->p_bump) < rounded)
+    {
+        // the tail of the previous chunk is simply abandoned
+        arena_chunk_t * p_chunk = malloc(ARENA_CHUNK_SIZE);
+
+        if (NULL == p_chunk)
+        {
+            perror("Failed to malloc memory for arena chunk\n");
+            goto EXIT;
+        }
+
+        p_chunk->size         = ARENA_CHUNK_SIZE;
+        p_chunk->p_prev       = NULL;
+        p_chunk->p_next       = p_arena->p_chunks;
+        p_arena->p_chunks     = p_chunk;
+        p_arena->p_bump       = (char *)p_chunk + ARENA_HEADER_SIZE;
+        p_arena->p_bump_end   = (char *)p_chunk + ARENA_CHUNK_SIZE;
+        p_arena->chunk_bytes += ARENA_CHUNK_SIZE;
+    }
+
+    p_ptr = p_arena->p_bump;
+    p_arena->p_bump += rounded;
+
+EXIT:
+    return (p_ptr);
+}
+
+/**
+ * @brief Returns memory to the arena. Small allocations are kept for reuse by
+ * allocations of the same rounded size; large ones go back to the system.
+ *
+ * @param p_arena Pointer to the arena.
+ * @param p_ptr Pointer returned by arena_alloc().
+ * @param size The size that was passed to arena_alloc().
+ */
+void arena_free (arena_t * p_arena, void * p_ptr, size_t size)
+{
+    if (0 == size)
+    {
+        size = 1;
+    }
+
+    size_t class_idx = (size - 1) / ARENA_GRANULE;
+
+    if (ARENA_CLASS_COUNT <= class_idx)
+    {
+        arena_chunk_t * p_chunk
+            = (arena_chunk_t *)((char *)p_ptr - ARENA_HEADER_SIZE);
+
+        if (NULL != p_chunk->p_prev)
+        {
+            p_chunk->p_prev->p_next = p_chunk->p_next;
+        }
+        else
+        {
+            p_arena->p_large = p_chunk->p_next;
+        }
+
+        if (NULL != p_chunk->p_next)
+        {
+            p_chunk->p_next->p_prev = p_chunk->p_prev;
+        }
+
+        p_arena->chunk_bytes -= p_chunk->size;
+        free(p_chunk);
+        return;
+    }
+
+    *(void **)p_ptr            = p_arena->p_free[class_idx];
+    p_arena->p_free[class_idx] = p_ptr;
+}
+
+/**
+ * @brief Releases all memory held by the arena.
+ *
+ * @param p_arena Pointer to the arena.
+ */
+void arena_destroy (arena_t * p_arena)
+{
+    arena_chunk_t * lists[] = { p_arena->p_chunks, p_arena->p_large };
+
+    for (uint32_t list_idx = 0; list_idx < 2; list_idx++)
+    {
+        arena_chunk_t * p_chunk = lists[list_idx];
+
+        while (NULL != p_chunk)
+        {
+            arena_chunk_t * p_next = p_chunk->p_next;
+            free(p_chunk);
+            p_chunk = p_next;
+        }
+    }
+
+    arena_init(p_arena);
+}
+
+/*** end of file ***/
@@ -0,0 +1,543 @@
+/**
+ * @file concurrent_hashtable.c
+ * @author Daniel Chung
+ * @brief A thread safe hashtable implementation that partitions its buckets
+ * into independently locked segments and lets readers run lock free.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/concurrent_hashtable.h"
+#include "../include/epoch.h"
+#include "../include/hash.h"
+#include "../include/errorcode.h"
+
+static cht_segment_t * cht_segment_for (cht_t * p_cht, uint32_t hash);
+static cht_table_t *   cht_table_create (size_t capacity);
+static void            cht_table_free (void * p_table);
+static void            cht_segment_grow (cht_segment_t * p_seg);
+
+/**
+ * @brief Creates a new concurrent hashtable on heap.
+ *
+ * @param segment_count Number of lock segments, rounded up to a power of two.
+ * 0 selects CHT_DEFAULT_SEGMENTS.
+ * @return cht_t* On success, returns a pointer to the newly created hashtable,
+ * else NULL.
+ */
+cht_t * cht_create (size_t segment_count)
+{
+    cht_t *  new_cht = NULL;
+    size_t   count   = 1;
+    uint32_t bits    = 0;
+
+    if (0 == segment_count)
+    {
+        segment_count = CHT_DEFAULT_SEGMENTS;
+    }
+
+    while ((count < segment_count) && (bits < 16))
+    {
+        count <<= 1;
+        bits++;
+    }
+
+    new_cht = malloc(sizeof(cht_t));
+
+    if (NULL == new_cht)
+    {
+        goto EXIT;
+    }
+
+    new_cht->segment_count = count;
+    new_cht->segment_shift = 32 - bits;
+    new_cht->p_segments
+        = aligned_alloc(_Alignof(cht_segment_t), count * sizeof(cht_segment_t));
+
+    if (NULL == new_cht->p_segments)
+    {
+        perror("Failed to allocate memory for hashtable segments\n");
+        free(new_cht);
+        new_cht = NULL;
+        goto EXIT;
+    }
+
+    for (size_t seg_idx = 0; seg_idx < count; seg_idx++)
+    {
+        cht_segment_t * p_seg   = &new_cht->p_segments[seg_idx];
+        cht_table_t *   p_table = cht_table_create(CHT_SEGMENT_BUCKETS);
+
+        if (NULL == p_table)
+        {
+            new_cht->segment_count = seg_idx;
+            cht_destroy(new_cht);
+            new_cht = NULL;
+            goto EXIT;
+        }
+
+        atomic_init(&p_seg->p_table, p_table);
+        p_seg->size = 0;
+        pthread_mutex_init(&p_seg->lock, NULL);
+    }
+
+EXIT:
+    return (new_cht);
+}
+
+/**
+ * @brief Destroys a concurrent hashtable. No other thread may be using it.
+ * Nodes retired earlier are still released by the epoch module.
+ *
+ * @param p_cht Pointer to the hashtable to be destroyed.
+ * @return error_t On success, returns 0, else non zero error
+ */
+error_t cht_destroy (cht_t * p_cht)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_cht)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    for (size_t seg_idx = 0; seg_idx < p_cht->segment_count; seg_idx++)
+    {
+        cht_segment_t * p_seg   = &p_cht->p_segments[seg_idx];
+        cht_table_t *   p_table = atomic_load(&p_seg->p_table);
+
+        for (size_t cap_idx = 0; cap_idx < p_table->capacity; cap_idx++)
+        {
+            cht_node_t * current = atomic_load(&p_table->pp_items[cap_idx]);
+
+            while (NULL != current)
+            {
+                cht_node_t * temp = current;
+                current           = atomic_load(&current->p_next);
+                free(temp);
+            }
+        }
+
+        cht_table_free(p_table);
+        pthread_mutex_destroy(&p_seg->lock);
+    }
+
+    free(p_cht->p_segments);
+    free(p_cht);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Inserts a key into the hashtable, replacing the value of an existing
+ * entry for the same key. Only the key's segment is locked. A new node is
+ * fully initialised before the release store that makes it visible.
+ *
+ * @param p_cht Pointer to the hashtable.
+ * @param p_key Char pointer to the key of the new entry.
+ * @param p_value Void pointer to the value of the new entry.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t cht_insert (cht_t * p_cht, char * p_key, void * p_value)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_cht || NULL == p_key)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    uint32_t        hash  = murmurhash(p_key, strlen(p_key), 0);
+    cht_segment_t * p_seg = cht_segment_for(p_cht, hash);
+
+    pthread_mutex_lock(&p_seg->lock);
+
+    cht_table_t *
+        p_table = atomic_load_explicit(&p_seg->p_table, memory_order_relaxed);
+    _Atomic(cht_node_t *) * p_head
+        = &p_table->pp_items[hash & (p_table->capacity - 1)];
+    cht_node_t * p_node = atomic_load_explicit(p_head, memory_order_relaxed);
+
+    while (NULL != p_node)
+    {
+        if ((hash == p_node->hash) && (0 == strcmp(p_key, p_node->p_key)))
+        {
+            atomic_store_explicit(
+                &p_node->p_value, p_value, memory_order_release);
+            retval = E_SUCCESS;
+            goto UNLOCK;
+        }
+
+        p_node = atomic_load_explicit(&p_node->p_next, memory_order_relaxed);
+    }
+
+    p_node = malloc(sizeof(cht_node_t));
+
+    if (NULL == p_node)
+    {
+        retval = E_NULL_PTR;
+        goto UNLOCK;
+    }
+
+    p_node->p_key = p_key;
+    p_node->hash  = hash;
+    atomic_init(&p_node->p_value, p_value);
+    atomic_init(&p_node->p_next,
+                atomic_load_explicit(p_head, memory_order_relaxed));
+    atomic_store_explicit(p_head, p_node, memory_order_release);
+    p_seg->size++;
+
+    // typecast to double to avoid integer division
+    if ((double)p_seg->size / p_table->capacity > 0.8)
+    {
+        cht_segment_grow(p_seg);
+    }
+
+    retval = E_SUCCESS;
+
+UNLOCK:
+    pthread_mutex_unlock(&p_seg->lock);
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Deletes a key from the hashtable. The node is unlinked with a single
+ * store, so a concurrent reader either still finds it or walks past it, and
+ * it is retired rather than freed.
+ *
+ * @param p_cht Pointer to the hashtable.
+ * @param p_key Char pointer to the key of the entry to be deleted.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t cht_delete (cht_t * p_cht, char * p_key)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_cht || NULL == p_key)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    uint32_t        hash  = murmurhash(p_key, strlen(p_key), 0);
+    cht_segment_t * p_seg = cht_segment_for(p_cht, hash);
+
+    pthread_mutex_lock(&p_seg->lock);
+
+    cht_table_t *
+        p_table = atomic_load_explicit(&p_seg->p_table, memory_order_relaxed);
+    _Atomic(cht_node_t *) * node
+        = &p_table->pp_items[hash & (p_table->capacity - 1)];
+    cht_node_t * current = atomic_load_explicit(node, memory_order_relaxed);
+
+    while (NULL != current)
+    {
+        if ((hash == current->hash) && (0 == strcmp(p_key, current->p_key)))
+        {
+            atomic_store_explicit(
+                node,
+                atomic_load_explicit(&current->p_next, memory_order_relaxed),
+                memory_order_release);
+            epoch_retire(current, free);
+            p_seg->size--;
+            retval = E_SUCCESS;
+            goto UNLOCK;
+        }
+
+        node    = &current->p_next;
+        current = atomic_load_explicit(node, memory_order_relaxed);
+    }
+
+    retval = E_NODE_NOT_FOUND;
+
+UNLOCK:
+    pthread_mutex_unlock(&p_seg->lock);
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Searches the hashtable for a key without taking any lock. The walk
+ * runs inside an epoch critical section, so nodes unlinked or replaced by a
+ * concurrent writer stay readable until it ends.
+ *
+ * @param p_cht Pointer to the hashtable.
+ * @param p_key Char pointer to the key to be searched for.
+ * @return void* On success, returns a pointer to the value of the key, else
+ * NULL.
+ */
+void * cht_search (cht_t * p_cht, char * p_key)
+{
+    void * retval = NULL;
+
+    if (NULL == p_cht || NULL == p_key)
+    {
+        goto EXIT;
+    }
+
+    uint32_t        hash  = murmurhash(p_key, strlen(p_key), 0);
+    cht_segment_t * p_seg = cht_segment_for(p_cht, hash);
+
+    epoch_enter();
+
+    cht_table_t *
+        p_table = atomic_load_explicit(&p_seg->p_table, memory_order_acquire);
+    size_t       index = hash & (p_table->capacity - 1);
+    cht_node_t * node
+        = atomic_load_explicit(&p_table->pp_items[index], memory_order_acquire);
+
+    while (NULL != node)
+    {
+        if ((hash == node->hash) && (0 == strcmp(p_key, node->p_key)))
+        {
+            retval = atomic_load_explicit(&node->p_value, memory_order_acquire);
+            break;
+        }
+
+        node = atomic_load_explicit(&node->p_next, memory_order_acquire);
+    }
+
+    epoch_exit();
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Updates the value of a key in place through a callback, creating
+ * the entry with a NULL value first if the key is absent. The callback runs
+ * under the key's segment lock, so updates of one key never interleave, and
+ * its result is published with a single release store that lock free readers
+ * observe either before or after, never half way.
+ *
+ * @param p_cht Pointer to the hashtable.
+ * @param p_key Char pointer to the key.
+ * @param update_fn Callback invoked once with a pointer to the value. It must
+ * not access the hashtable.
+ * @param p_ctx Opaque pointer handed to update_fn.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t cht_update_with (cht_t *         p_cht,
+                         char *          p_key,
+                         cht_update_fn_t update_fn,
+                         void *          p_ctx)
+{
+    error_t retval  = E_GENERAL;
+    void *  p_value = NULL;
+
+    if (NULL == p_cht || NULL == p_key || NULL == update_fn)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    uint32_t        hash  = murmurhash(p_key, strlen(p_key), 0);
+    cht_segment_t * p_seg = cht_segment_for(p_cht, hash);
+
+    pthread_mutex_lock(&p_seg->lock);
+
+    cht_table_t *
+        p_table = atomic_load_explicit(&p_seg->p_table, memory_order_relaxed);
+    _Atomic(cht_node_t *) * p_head
+        = &p_table->pp_items[hash & (p_table->capacity - 1)];
+    cht_node_t * p_node = atomic_load_explicit(p_head, memory_order_relaxed);
+
+    while (NULL != p_node)
+    {
+        if ((hash == p_node->hash) && (0 == strcmp(p_key, p_node->p_key)))
+        {
+            p_value = atomic_load_explicit(&p_node->p_value,
+                                           memory_order_relaxed);
+            update_fn(&p_value, 0, p_ctx);
+            atomic_store_explicit(
+                &p_node->p_value, p_value, memory_order_release);
+            retval = E_SUCCESS;
+            goto UNLOCK;
+        }
+
+        p_node = atomic_load_explicit(&p_node->p_next, memory_order_relaxed);
+    }
+
+    p_node = malloc(sizeof(cht_node_t));
+
+    if (NULL == p_node)
+    {
+        retval = E_NULL_PTR;
+        goto UNLOCK;
+    }
+
+    // the new entry stays private until the callback has filled it in
+    update_fn(&p_value, 1, p_ctx);
+    p_node->p_key = p_key;
+    p_node->hash  = hash;
+    atomic_init(&p_node->p_value, p_value);
+    atomic_init(&p_node->p_next,
+                atomic_load_explicit(p_head, memory_order_relaxed));
+    atomic_store_explicit(p_head, p_node, memory_order_release);
+    p_seg->size++;
+
+    // typecast to double to avoid integer division
+    if ((double)p_seg->size / p_table->capacity > 0.8)
+    {
+        cht_segment_grow(p_seg);
+    }
+
+    retval = E_SUCCESS;
+
+UNLOCK:
+    pthread_mutex_unlock(&p_seg->lock);
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that returns the segment owning a hash.
+ *
+ * @param p_cht Pointer to the hashtable.
+ * @param hash Hash of the key.
+ * @return cht_segment_t* The segment.
+ */
+static cht_segment_t * cht_segment_for (cht_t * p_cht, uint32_t hash)
+{
+    // widen first, a single segment shifts by the full 32 bits
+    return (&p_cht->p_segments[(uint64_t)hash >> p_cht->segment_shift]);
+}
+
+/**
+ * @brief A private function that allocates an empty bucket array.
+ *
+ * @param capacity Number of buckets, a power of two.
+ * @return cht_table_t* On success, returns the table, else NULL.
+ */
+static cht_table_t * cht_table_create (size_t capacity)
+{
+    cht_table_t * p_table = calloc(
+        1, sizeof(cht_table_t) + capacity * sizeof(_Atomic(cht_node_t *)));
+
+    if (NULL == p_table)
+    {
+        perror("Failed to calloc memory for hashtable items\n");
+        return (NULL);
+    }
+
+    p_table->capacity = capacity;
+
+    for (size_t cap_idx = 0; cap_idx < capacity; cap_idx++)
+    {
+        atomic_init(&p_table->pp_items[cap_idx], NULL);
+    }
+
+    return (p_table);
+}
+
+/**
+ * @brief A private function that frees a bucket array, but not its nodes.
+ *
+ * @param p_table Pointer to the table.
+ */
+static void cht_table_free (void * p_table)
+{
+    free(p_table);
+}
+
+/**
+ * @brief A private function that doubles the bucket count of a segment. The
+ * caller holds the segment's lock; no other segment is touched.
+ *
+ * Readers may be walking the current chains, so nodes cannot be relinked in
+ * place. Every node is copied into the new table, the new table is published
+ * with one release store and the old table and nodes are retired.
+ *
+ * @param p_seg Pointer to the segment.
+ */
+static void cht_segment_grow (cht_segment_t * p_seg)
+{
+    cht_table_t * p_old
+        = atomic_load_explicit(&p_seg->p_table, memory_order_relaxed);
+    cht_table_t * p_new = cht_table_create(p_old->capacity << 1);
+
+    if (NULL == p_new)
+    {
+        return;
+    }
+
+    for (size_t cap_idx = 0; cap_idx < p_old->capacity; cap_idx++)
+    {
+        cht_node_t * p_node = atomic_load_explicit(&p_old->pp_items[cap_idx],
+                                                   memory_order_relaxed);
+
+        while (NULL != p_node)
+        {
+            cht_node_t * p_copy = malloc(sizeof(cht_node_t));
+
+            if (NULL == p_copy)
+            {
+                perror("Failed to malloc memory for hashtable node\n");
+                goto ABORT;
+            }
+
+            _Atomic(cht_node_t *) * p_head
+                = &p_new->pp_items[p_node->hash & (p_new->capacity - 1)];
+
+            p_copy->p_key = p_node->p_key;
+            p_copy->hash  = p_node->hash;
+            atomic_init(&p_copy->p_value,
+                        atomic_load_explicit(&p_node->p_value,
+                                             memory_order_relaxed));
+            atomic_init(&p_copy->p_next,
+                        atomic_load_explicit(p_head, memory_order_relaxed));
+            atomic_store_explicit(p_head, p_copy, memory_order_relaxed);
+
+            p_node
+                = atomic_load_explicit(&p_node->p_next, memory_order_relaxed);
+        }
+    }
+
+    atomic_store_explicit(&p_seg->p_table, p_new, memory_order_release);
+
+    for (size_t cap_idx = 0; cap_idx < p_old->capacity; cap_idx++)
+    {
+        cht_node_t * p_node = atomic_load_explicit(&p_old->pp_items[cap_idx],
+                                                   memory_order_relaxed);
+
+        while (NULL != p_node)
+        {
+            cht_node_t * p_next
+                = atomic_load_explicit(&p_node->p_next, memory_order_relaxed);
+            epoch_retire(p_node, free);
+            p_node = p_next;
+        }
+    }
+
+    epoch_retire(p_old, cht_table_free);
+    return;
+
+ABORT:
+    // the new table was never published, free it directly
+    for (size_t cap_idx = 0; cap_idx < p_new->capacity; cap_idx++)
+    {
+        cht_node_t * p_node = atomic_load_explicit(&p_new->pp_items[cap_idx],
+                                                   memory_order_relaxed);
+
+        while (NULL != p_node)
+        {
+            cht_node_t * p_next
+                = atomic_load_explicit(&p_node->p_next, memory_order_relaxed);
+            free(p_node);
+            p_node = p_next;
+        }
+    }
+
+    cht_table_free(p_new);
+}
+
+/*** end of file ***/
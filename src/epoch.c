@@ -0,0 +1,299 @@
+/**
+ * @file epoch.c
+ * @author Daniel Chung
+ * @brief Epoch based reclamation for memory that lock free readers may still
+ * be looking at.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../include/epoch.h"
+
+/**
+ * @brief Garbage is kept in three bags per thread, indexed by the global
+ * epoch it was retired in. Memory retired in epoch e is freed once the global
+ * epoch reaches e + 2, because every thread inside a critical section has
+ * then moved past e.
+ */
+#define EPOCH_BAG_COUNT 3
+
+typedef struct epoch_retired_t
+{
+    void *        p_ptr;
+    epoch_free_fn free_fn;
+} epoch_retired_t;
+
+typedef struct epoch_bag_t
+{
+    epoch_retired_t * p_items;
+    size_t            count;
+    size_t            capacity;
+    uint64_t          epoch;
+} epoch_bag_t;
+
+typedef struct epoch_record_t
+{
+    _Atomic uint64_t        local_epoch;
+    _Atomic uint32_t        active;
+    _Atomic uint32_t        in_use;
+    uint32_t                nesting;
+    uint32_t                retire_count;
+    epoch_bag_t             bags[EPOCH_BAG_COUNT];
+    struct epoch_record_t * p_next;
+} epoch_record_t;
+
+static _Atomic uint64_t          g_epoch   = 0;
+static _Atomic(epoch_record_t *) g_records = NULL;
+static pthread_key_t             g_record_key;
+static pthread_once_t            g_record_once = PTHREAD_ONCE_INIT;
+static _Thread_local epoch_record_t * tl_record = NULL;
+
+static epoch_record_t * epoch_record (void);
+static void             epoch_record_key_init (void);
+static void             epoch_record_release (void * p_record);
+static void             epoch_try_advance (void);
+static void             epoch_bag_free (epoch_bag_t * p_bag);
+
+/**
+ * @brief Enters a read side critical section. Shared nodes loaded inside it
+ * stay valid until the matching epoch_exit().
+ */
+void epoch_enter (void)
+{
+    epoch_record_t * p_rec = epoch_record();
+
+    if (0 != p_rec->nesting++)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&p_rec->active, 1, memory_order_relaxed);
+
+    // republish until the epoch observed is still current after the fence
+    uint64_t epoch = 0;
+
+    do
+    {
+        epoch = atomic_load_explicit(&g_epoch, memory_order_relaxed);
+        atomic_store_explicit(&p_rec->local_epoch, epoch, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+    } while (epoch != atomic_load_explicit(&g_epoch, memory_order_relaxed));
+}
+
+/**
+ * @brief Leaves a read side critical section.
+ */
+void epoch_exit (void)
+{
+    epoch_record_t * p_rec = epoch_record();
+
+    if (0 == --p_rec->nesting)
+    {
+        atomic_store_explicit(&p_rec->active, 0, memory_order_release);
+    }
+}
+
+/**
+ * @brief Defers freeing memory that has been unlinked from a shared structure
+ * until no reader can still hold a reference to it.
+ *
+ * @param p_ptr Pointer to the memory to be freed.
+ * @param free_fn Function that releases it.
+ */
+void epoch_retire (void * p_ptr, epoch_free_fn free_fn)
+{
+    epoch_record_t * p_rec = epoch_record();
+    uint64_t epoch = atomic_load_explicit(&g_epoch, memory_order_acquire);
+    epoch_bag_t * p_bag = &p_rec->bags[epoch % EPOCH_BAG_COUNT];
+
+    // a bag tagged with another epoch holds garbage from epoch - 3 or older
+    if (epoch != p_bag->epoch)
+    {
+        epoch_bag_free(p_bag);
+        p_bag->epoch = epoch;
+    }
+
+    if (p_bag->count == p_bag->capacity)
+    {
+        size_t            new_capacity = p_bag->capacity ? p_bag->capacity * 2
+                                                         : EPOCH_RETIRE_BATCH;
+        epoch_retired_t * p_items
+            = realloc(p_bag->p_items, new_capacity * sizeof(epoch_retired_t));
+
+        if (NULL == p_items)
+        {
+            // leaking is the only choice that cannot hand a reader freed memory
+            perror("Failed to grow epoch garbage bag\n");
+            return;
+        }
+
+        p_bag->p_items  = p_items;
+        p_bag->capacity = new_capacity;
+    }
+
+    p_bag->p_items[p_bag->count].p_ptr   = p_ptr;
+    p_bag->p_items[p_bag->count].free_fn = free_fn;
+    p_bag->count++;
+
+    if (0 != (++p_rec->retire_count % EPOCH_RETIRE_BATCH))
+    {
+        return;
+    }
+
+    epoch_try_advance();
+    epoch = atomic_load_explicit(&g_epoch, memory_order_acquire);
+
+    for (uint32_t bag_idx = 0; bag_idx < EPOCH_BAG_COUNT; bag_idx++)
+    {
+        if (p_rec->bags[bag_idx].epoch + 2 <= epoch)
+        {
+            epoch_bag_free(&p_rec->bags[bag_idx]);
+        }
+    }
+}
+
+/**
+ * @brief Frees everything retired by any thread. Only safe while no thread is
+ * inside a critical section or retiring memory, e.g. at shutdown.
+ */
+void epoch_drain (void)
+{
+    epoch_record_t * p_rec = atomic_load_explicit(&g_records,
+                                                  memory_order_acquire);
+
+    while (NULL != p_rec)
+    {
+        for (uint32_t bag_idx = 0; bag_idx < EPOCH_BAG_COUNT; bag_idx++)
+        {
+            epoch_bag_free(&p_rec->bags[bag_idx]);
+        }
+
+        p_rec = p_rec->p_next;
+    }
+}
+
+/**
+ * @brief A private function that returns the calling thread's record,
+ * claiming a released one or registering a new one on first use. Records are
+ * never freed, so the lock free list walk in epoch_try_advance() stays safe.
+ *
+ * @return epoch_record_t* The record.
+ */
+static epoch_record_t * epoch_record (void)
+{
+    if (NULL != tl_record)
+    {
+        return (tl_record);
+    }
+
+    pthread_once(&g_record_once, epoch_record_key_init);
+
+    epoch_record_t * p_rec = atomic_load_explicit(&g_records,
+                                                  memory_order_acquire);
+
+    while (NULL != p_rec)
+    {
+        uint32_t expected = 0;
+
+        if (atomic_compare_exchange_strong(&p_rec->in_use, &expected, 1))
+        {
+            break;
+        }
+
+        p_rec = p_rec->p_next;
+    }
+
+    if (NULL == p_rec)
+    {
+        p_rec = calloc(1, sizeof(epoch_record_t));
+
+        if (NULL == p_rec)
+        {
+            perror("Failed to calloc memory for epoch record\n");
+            abort();
+        }
+
+        atomic_store(&p_rec->in_use, 1);
+        p_rec->p_next = atomic_load(&g_records);
+
+        while (!atomic_compare_exchange_weak(&g_records, &p_rec->p_next, p_rec))
+        {
+        }
+    }
+
+    pthread_setspecific(g_record_key, p_rec);
+    tl_record = p_rec;
+
+    return (p_rec);
+}
+
+/**
+ * @brief A private function that creates the key whose destructor hands a
+ * record back when its thread exits.
+ */
+static void epoch_record_key_init (void)
+{
+    pthread_key_create(&g_record_key, epoch_record_release);
+}
+
+/**
+ * @brief A private function that releases a record for reuse. Its garbage
+ * stays in the bags and is freed by the next owner.
+ *
+ * @param p_record Pointer to the record.
+ */
+static void epoch_record_release (void * p_record)
+{
+    epoch_record_t * p_rec = p_record;
+
+    p_rec->nesting = 0;
+    atomic_store_explicit(&p_rec->active, 0, memory_order_release);
+    atomic_store_explicit(&p_rec->in_use, 0, memory_order_release);
+}
+
+/**
+ * @brief A private function that moves the global epoch forward if every
+ * thread inside a critical section has observed the current one.
+ */
+static void epoch_try_advance (void)
+{
+    uint64_t epoch = atomic_load(&g_epoch);
+
+    atomic_thread_fence(memory_order_seq_cst);
+
+    for (epoch_record_t * p_rec = atomic_load(&g_records); NULL != p_rec;
+         p_rec                  = p_rec->p_next)
+    {
+        if ((0 != atomic_load(&p_rec->active))
+            && (epoch != atomic_load(&p_rec->local_epoch)))
+        {
+            return;
+        }
+    }
+
+    atomic_compare_exchange_strong(&g_epoch, &epoch, epoch + 1);
+}
+
+/**
+ * @brief A private function that frees everything in a bag.
+ *
+ * @param p_bag Pointer to the bag.
+ */
+static void epoch_bag_free (epoch_bag_t * p_bag)
+{
+    for (size_t item_idx = 0; item_idx < p_bag->count; item_idx++)
+    {
+        p_bag->p_items[item_idx].free_fn(p_bag->p_items[item_idx].p_ptr);
+    }
+
+    p_bag->count = 0;
+}
+
+/*** end of file ***/
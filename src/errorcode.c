@@ -21,6 +21,8 @@ struct error_desc_t error_desc_t[] = {
     { E_HASHTABLE_DELETE, "Hashtable deletion error" },
     { E_HASHTABLE_DESTROY, "Hashtable destruction error" },
     { E_NODE_NOT_FOUND, "Node not found" },
+    { E_KEY_EXISTS, "Key already exists" },
+    { E_NOT_SUPPORTED, "Not supported by this build" },
 };
 
 /*** end of file ***/
\ No newline at end of file
@@ -0,0 +1,335 @@
+/**
+ * @file hash.c
+ * @author Daniel Chung
+ * @brief Hash functions shared by the hashtable implementations.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "../include/hash.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+static uint64_t hash_fmix64 (uint64_t hash);
+static uint32_t crc32c_sw (uint32_t crc, const uint8_t * p_data, size_t len);
+
+// NOLINTBEGIN
+/**
+ * @brief An implementation of MurmurHash3.
+ * Credit: https://github.com/jwerle/murmurhash.c
+ *
+ * @param p_key Pointer to the p_key to be hashed.
+ * @param len Length of the p_key.
+ * @param seed Seed value for the hash.
+ * @return uint32_t Returns the hash value of the p_key.
+ */
+
+uint32_t murmurhash (const void * key_ptr, int length, uint32_t seed)
+{
+    uint32_t         const1     = 0xcc9e2d51;
+    uint32_t         const2     = 0x1b873593;
+    uint32_t         shift1     = 15;
+    uint32_t         shift2     = 13;
+    uint32_t         multiplier = 5;
+    uint32_t         adder      = 0xe6546b64;
+    uint32_t         hash       = 0;
+    uint32_t         key_chunk  = 0;
+    uint8_t *        data = (uint8_t *)key_ptr; // 32 bit extract from `p_key'
+    const uint32_t * chunks_ptr = NULL;
+    const uint8_t *  tail_ptr   = NULL; // tail - last 8 bytes
+    int              index      = 0;
+    int              chunk_len  = length / 4; // chunk length
+    hash                        = seed;
+    chunks_ptr                  = (const uint32_t *)(data + chunk_len * 4);
+    tail_ptr                    = (const uint8_t *)(data + chunk_len * 4);
+
+    // for each 4 byte chunk of `p_key'
+    for (index = -chunk_len; index != 0; ++index)
+    {
+        // next 4 byte chunk of `p_key'
+        key_chunk = chunks_ptr[index];
+        // encode next 4 byte chunk of `p_key'
+        key_chunk *= const1;
+        key_chunk = (key_chunk << shift1) | (key_chunk >> (32 - shift1));
+        key_chunk *= const2;
+        // append to hash
+        hash ^= key_chunk;
+        hash = (hash << shift2) | (hash >> (32 - shift2));
+        hash = hash * multiplier + adder;
+    }
+
+    key_chunk = 0;
+
+// In this switch case, we want the cases to fall through.
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+    switch (length & 3)
+    { // `len % 4'
+        case 3:
+            key_chunk ^= (tail_ptr[2] << 16);
+        case 2:
+            key_chunk ^= (tail_ptr[1] << 8);
+        case 1:
+            key_chunk ^= tail_ptr[0];
+            key_chunk *= const1;
+            key_chunk = (key_chunk << shift1) | (key_chunk >> (32 - shift1));
+            key_chunk *= const2;
+            hash ^= key_chunk;
+    }
+
+    hash ^= length;
+    hash ^= (hash >> 16);
+    hash *= 0x85ebca6b;
+    hash ^= (hash >> 13);
+    hash *= 0xc2b2ae35;
+    hash ^= (hash >> 16);
+
+    return hash;
+}
+
+// NOLINTEND
+
+/**
+ * @brief MurmurHash3 in the hash_fn_t shape. With seed 0 it gives the same
+ * hash the tables have always used.
+ *
+ * @param p_key Pointer to the key to be hashed.
+ * @param len Length of the key in bytes.
+ * @param seed Seed value, truncated to 32 bits.
+ * @return uint64_t Returns the 32 bit hash value of the key.
+ */
+uint64_t hash_murmur3 (const void * p_key, size_t len, uint64_t seed)
+{
+    return (murmurhash(p_key, (int)len, (uint32_t)seed));
+}
+
+/**
+ * @brief A private function that multiplies two 64 bit values and folds the
+ * 128 bit product, the mixing step of wyhash.
+ */
+static inline uint64_t wy_mum (uint64_t lhs, uint64_t rhs)
+{
+    __uint128_t product = (__uint128_t)lhs * rhs;
+
+    return ((uint64_t)product ^ (uint64_t)(product >> 64));
+}
+
+static inline uint64_t wy_read8 (const uint8_t * p_data)
+{
+    uint64_t value = 0;
+
+    memcpy(&value, p_data, sizeof(value));
+    return (value);
+}
+
+static inline uint64_t wy_read4 (const uint8_t * p_data)
+{
+    uint32_t value = 0;
+
+    memcpy(&value, p_data, sizeof(value));
+    return (value);
+}
+
+/**
+ * @brief A 64 bit hash in the style of wyhash (final version 4): eight or
+ * sixteen bytes per step, each step one 64x64->128 bit multiply.
+ * Credit: https://github.com/wangyi-fudan/wyhash (public domain)
+ *
+ * @param p_key Pointer to the key to be hashed.
+ * @param len Length of the key in bytes.
+ * @param seed Seed value for the hash.
+ * @return uint64_t Returns the hash value of the key.
+ */
+uint64_t hash_wy64 (const void * p_key, size_t len, uint64_t seed)
+{
+    static const uint64_t secret[4]
+        = { UINT64_C(0xa0761d6478bd642f), UINT64_C(0xe7037ed1a0b428db),
+            UINT64_C(0x8ebc6af09c88c6e3), UINT64_C(0x589965cc75374cc3) };
+    const uint8_t * p_data = p_key;
+    uint64_t        lhs    = 0;
+    uint64_t        rhs    = 0;
+
+    seed ^= wy_mum(seed ^ secret[0], secret[1]);
+
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            size_t offset = (len >> 3) << 2;
+
+            lhs = (wy_read4(p_data) << 32) | wy_read4(p_data + offset);
+            rhs = (wy_read4(p_data + len - 4) << 32)
+                  | wy_read4(p_data + len - 4 - offset);
+        }
+        else if (len > 0)
+        {
+            lhs = ((uint64_t)p_data[0] << 16)
+                  | ((uint64_t)p_data[len >> 1] << 8) | p_data[len - 1];
+        }
+    }
+    else
+    {
+        size_t remaining = len;
+
+        if (remaining > 48)
+        {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+
+            do
+            {
+                seed  = wy_mum(wy_read8(p_data) ^ secret[1],
+                              wy_read8(p_data + 8) ^ seed);
+                seed1 = wy_mum(wy_read8(p_data + 16) ^ secret[2],
+                               wy_read8(p_data + 24) ^ seed1);
+                seed2 = wy_mum(wy_read8(p_data + 32) ^ secret[3],
+                               wy_read8(p_data + 40) ^ seed2);
+                p_data += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining > 16)
+        {
+            seed = wy_mum(wy_read8(p_data) ^ secret[1],
+                          wy_read8(p_data + 8) ^ seed);
+            p_data += 16;
+            remaining -= 16;
+        }
+
+        lhs = wy_read8(p_data + remaining - 16);
+        rhs = wy_read8(p_data + remaining - 8);
+    }
+
+    __uint128_t product = (__uint128_t)(lhs ^ secret[1]) * (rhs ^ seed);
+
+    lhs = (uint64_t)product;
+    rhs = (uint64_t)(product >> 64);
+
+    return (wy_mum(lhs ^ secret[0] ^ len, rhs ^ secret[1]));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief A private function that runs CRC32C with the SSE4.2 crc32
+ * instruction, eight bytes at a time.
+ */
+__attribute__((target("sse4.2"))) static uint32_t
+crc32c_hw (uint32_t crc, const uint8_t * p_data, size_t len)
+{
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+
+    for (; len >= 8; len -= 8, p_data += 8)
+    {
+        crc64 = _mm_crc32_u64(crc64, wy_read8(p_data));
+    }
+
+    crc = (uint32_t)crc64;
+#endif
+
+    for (; len > 0; len--, p_data++)
+    {
+        crc = _mm_crc32_u8(crc, *p_data);
+    }
+
+    return (crc);
+}
+#elif defined(__ARM_FEATURE_CRC32)
+/**
+ * @brief A private function that runs CRC32C with the ARMv8 crc32c
+ * instructions, eight bytes at a time.
+ */
+static uint32_t crc32c_hw (uint32_t crc, const uint8_t * p_data, size_t len)
+{
+    for (; len >= 8; len -= 8, p_data += 8)
+    {
+        crc = __crc32cd(crc, wy_read8(p_data));
+    }
+
+    for (; len > 0; len--, p_data++)
+    {
+        crc = __crc32cb(crc, *p_data);
+    }
+
+    return (crc);
+}
+#endif
+
+/**
+ * @brief CRC32C (Castagnoli) of the key, using the CPU's CRC instruction
+ * when there is one, followed by a 64 bit finalizer so every output bit
+ * depends on every input bit. A CRC alone is linear and leaves its high bits
+ * poorly mixed.
+ *
+ * @param p_key Pointer to the key to be hashed.
+ * @param len Length of the key in bytes.
+ * @param seed Seed value for the hash.
+ * @return uint64_t Returns the hash value of the key.
+ */
+uint64_t hash_crc32c (const void * p_key, size_t len, uint64_t seed)
+{
+    uint32_t crc = (uint32_t)seed ^ UINT32_C(0xFFFFFFFF);
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        crc = crc32c_hw(crc, p_key, len);
+    }
+    else
+    {
+        crc = crc32c_sw(crc, p_key, len);
+    }
+#elif defined(__ARM_FEATURE_CRC32)
+    crc = crc32c_hw(crc, p_key, len);
+#else
+    crc = crc32c_sw(crc, p_key, len);
+#endif
+
+    return (hash_fmix64((((uint64_t)crc) << 32) ^ len ^ (seed >> 32)));
+}
+
+/**
+ * @brief A private function that computes CRC32C one bit at a time, for CPUs
+ * without a CRC instruction.
+ */
+static uint32_t crc32c_sw (uint32_t crc, const uint8_t * p_data, size_t len)
+{
+    for (; len > 0; len--, p_data++)
+    {
+        crc ^= *p_data;
+
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (UINT32_C(0x82F63B78) & (0 - (crc & 1)));
+        }
+    }
+
+    return (crc);
+}
+
+/**
+ * @brief A private function implementing the MurmurHash3 64 bit finalizer.
+ */
+static uint64_t hash_fmix64 (uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xff51afd7ed558ccd);
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xc4ceb3fe1a85ec53);
+    hash ^= hash >> 33;
+
+    return (hash);
+}
+
+/*** end of file ***/
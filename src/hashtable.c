@@ -12,25 +12,82 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 #include "../include/hashtable.h"
+#include "../include/hash.h"
 #include "../include/errorcode.h"
 
+#ifdef HT_ENABLE_METRICS
+#include <stdatomic.h>
+
+#define HT_METRIC_ADD(p_ht, metric, count) \
+    ht_metric_add((p_ht), (metric), (count))
+#define HT_SAMPLE_BEGIN(p_ht) \
+    uint64_t ht_sample_start = ht_sample_begin(p_ht)
+#define HT_SAMPLE_END(p_ht, op) ht_sample_end((p_ht), (op), ht_sample_start)
+#else
+// evaluate count so a local that only feeds a metric is still used
+#define HT_METRIC_ADD(p_ht, metric, count) ((void)(count))
+#define HT_SAMPLE_BEGIN(p_ht)
+#define HT_SAMPLE_END(p_ht, op)
+#endif
+
 /**
  * @brief A global array full of prime numbers
  * The largest prime number can account for 4,412,637 years. This *should* be
  * enough.
  * Credit: https://planetmath.org/goodhashtableprimes
  */
-uint32_t g_primes[]
+uint32_t g_primes[HT_PRIME_COUNT]
     = { 53,        97,        193,      389,       769,       1543,
         3079,      6151,      12289,    24593,     49157,     98317,
         196613,    393241,    786433,   1572869,   3145739,   6291469,
         12582917,  25165843,  50331653, 100663319, 201326611, 402653189,
         805306457, 1610612741 };
 
-uint32_t hash_str (char * p_key);
-uint32_t murmurhash (const void * p_key, int len, uint32_t seed);
-node_t * node_create (char * p_key, void * p_value);
+uint32_t    hash_key (ht_t * p_ht, const void * p_key, size_t key_len);
+node_t *    node_create (ht_t *       p_ht,
+                         const void * p_key,
+                         size_t       key_len,
+                         void *       p_value,
+                         uint32_t     hash);
+static void node_free (ht_t * p_ht, node_t * p_node);
+static node_t * ht_find_or_insert (ht_t **      pp_ht,
+                                   const void * p_key,
+                                   size_t       key_len,
+                                   void *       p_value,
+                                   int *        p_created);
+static void     ht_link_node (ht_t * p_ht, node_t * p_node, uint32_t index);
+static int  node_matches (node_t *     p_node,
+                          const void * p_key,
+                          size_t       key_len,
+                          uint32_t     hash);
+static size_t   ht_class_capacity (ht_t * p_ht, uint32_t class_index);
+static uint64_t ht_fastmod_m (size_t capacity);
+static uint32_t ht_bucket_index (ht_t *   p_ht,
+                                 uint32_t hash,
+                                 size_t   capacity,
+                                 uint64_t fastmod_m);
+static uint32_t ht_class_for_count (ht_t *   p_ht,
+                                    uint32_t min_index,
+                                    size_t   count);
+static error_t  ht_resize_full (ht_t * p_ht, uint32_t class_index);
+static void ht_resize_incremental (ht_t * p_ht, uint32_t class_index);
+static void ht_shrink_auto (ht_t * p_ht);
+static void ht_relink_chain (ht_t * p_ht, node_t * p_chain);
+static void ht_migrate_bucket (ht_t * p_ht, size_t old_index);
+static void ht_migrate_key (ht_t * p_ht, uint32_t hash);
+static void ht_migrate_step (ht_t * p_ht);
+static void ht_migrate_finish (ht_t * p_ht);
+static error_t ht_compact_nodes (ht_t * p_ht);
+#ifdef HT_ENABLE_METRICS
+static ht_metrics_shard_t * ht_metrics_shard (ht_t * p_ht);
+static void     ht_metric_add (ht_t * p_ht, ht_metric_t metric, uint64_t count);
+static uint64_t ht_sample_begin (ht_t * p_ht);
+static void     ht_sample_end (ht_t *         p_ht,
+                               ht_sample_op_t op,
+                               uint64_t       start);
+#endif
 
 /**
  * @brief Creates a new hashtable on heap.
@@ -41,21 +98,120 @@ node_t * node_create (char * p_key, void * p_value);
  */
 ht_t * ht_create (int prime_index)
 {
-    ht_t * new_ht = malloc(sizeof(ht_t));
+    ht_opts_t opts = { .prime_index     = prime_index,
+                       .resize_mode     = HT_RESIZE_FULL,
+                       .capacity_policy = HT_CAPACITY_PRIME,
+                       .key_mode        = HT_KEYS_BORROWED,
+                       .hash_fn         = hash_murmur3,
+                       .hash_seed       = 0 };
+
+    return (ht_create_opts(&opts));
+}
+
+/**
+ * @brief Creates a new hashtable on heap that is sized to hold a number of
+ * entries without resizing.
+ *
+ * @param expected_entries Number of entries the table is expected to hold.
+ * @return ht_t* On success, returns a pointer to the newly created hashtable,
+ * else NULL.
+ */
+ht_t * ht_create_reserve (size_t expected_entries)
+{
+    ht_opts_t opts = { .prime_index      = 0,
+                       .resize_mode      = HT_RESIZE_FULL,
+                       .capacity_policy  = HT_CAPACITY_PRIME,
+                       .key_mode         = HT_KEYS_BORROWED,
+                       .hash_fn          = hash_murmur3,
+                       .hash_seed        = 0,
+                       .expected_entries = expected_entries };
+
+    return (ht_create_opts(&opts));
+}
+
+/**
+ * @brief Creates a new hashtable on heap with the given options.
+ *
+ * @param p_opts Pointer to the creation options.
+ * @return ht_t* On success, returns a pointer to the newly created hashtable,
+ * else NULL.
+ */
+ht_t * ht_create_opts (const ht_opts_t * p_opts)
+{
+    ht_t * new_ht = NULL;
+
+    if (NULL == p_opts || 0 > p_opts->prime_index
+        || HT_PRIME_COUNT <= (size_t)p_opts->prime_index)
+    {
+        goto EXIT;
+    }
+
+    new_ht = malloc(sizeof(ht_t));
 
     if (NULL == new_ht)
     {
         goto EXIT;
     }
 
-    new_ht->size        = 0;
-    new_ht->prime_index = prime_index;
-    new_ht->capacity    = g_primes[new_ht->prime_index];
-    new_ht->pp_items    = calloc(new_ht->capacity, sizeof(node_t *));
+    new_ht->size            = 0;
+    new_ht->used_buckets    = 0;
+    new_ht->max_load_factor = (0 < p_opts->max_load_factor)
+                                  ? p_opts->max_load_factor
+                                  : HT_MAX_LOAD;
+    new_ht->prime_index     = p_opts->prime_index;
+    new_ht->resize_mode     = p_opts->resize_mode;
+    new_ht->capacity_policy = p_opts->capacity_policy;
+    new_ht->key_mode        = p_opts->key_mode;
+    new_ht->hash_fn         = p_opts->hash_fn ? p_opts->hash_fn : hash_murmur3;
+    new_ht->hash_seed       = p_opts->hash_seed;
+    new_ht->pp_old_items    = NULL;
+    new_ht->old_capacity    = 0;
+    new_ht->old_fastmod_m   = 0;
+    new_ht->migrate_index   = 0;
+    new_ht->resize_count    = 0;
+    new_ht->resize_ns       = 0;
+#ifdef HT_ENABLE_METRICS
+    new_ht->metrics_sample_every = p_opts->metrics_sample_every;
+    new_ht->p_metrics            = aligned_alloc(
+        _Alignof(ht_metrics_shard_t),
+        HT_METRICS_SHARDS * sizeof(ht_metrics_shard_t));
+
+    if (NULL == new_ht->p_metrics)
+    {
+        perror("Failed to allocate memory for hashtable metrics\n");
+        free(new_ht);
+        new_ht = NULL;
+        goto EXIT;
+    }
+
+    memset(new_ht->p_metrics,
+           0,
+           HT_METRICS_SHARDS * sizeof(ht_metrics_shard_t));
+#endif
+
+    // the expected count can only raise the size class picked by prime_index
+    if (0 != p_opts->expected_entries)
+    {
+        new_ht->prime_index = ht_class_for_count(
+            new_ht, new_ht->prime_index, p_opts->expected_entries);
+    }
+
+    new_ht->min_index = new_ht->prime_index;
+
+    new_ht->capacity  = ht_class_capacity(new_ht, new_ht->prime_index);
+    new_ht->fastmod_m = ht_fastmod_m(new_ht->capacity);
+    new_ht->pp_items  = calloc(new_ht->capacity, sizeof(node_t *));
+    pool_init(&new_ht->node_pool,
+              (HT_KEYS_OWNED == new_ht->key_mode) ? HT_OWNED_NODE_SIZE
+                                                  : sizeof(node_t));
+    arena_init(&new_ht->key_arena);
 
     if (NULL == new_ht->pp_items)
     {
         perror("Failed to calloc memory for hashtable items\n");
+#ifdef HT_ENABLE_METRICS
+        free(new_ht->p_metrics);
+#endif
         free(new_ht);
         new_ht = NULL;
         goto EXIT;
@@ -81,19 +237,14 @@ error_t ht_destroy (ht_t * p_ht)
         goto EXIT;
     }
 
-    for (uint32_t cap_idx = 0; cap_idx < p_ht->capacity; cap_idx++)
-    {
-        node_t * current = p_ht->pp_items[cap_idx];
-
-        while (current != NULL)
-        {
-            node_t * temp = current;
-            current       = current->p_next;
-            free(temp);
-        }
-    }
-
+    // every node lives in the pool, so there is no need to walk the chains
+    pool_destroy(&p_ht->node_pool);
+    arena_destroy(&p_ht->key_arena);
+    free(p_ht->pp_old_items);
     free(p_ht->pp_items);
+#ifdef HT_ENABLE_METRICS
+    free(p_ht->p_metrics);
+#endif
     free(p_ht);
     p_ht   = NULL;
     retval = E_SUCCESS;
@@ -103,281 +254,1551 @@ EXIT:
 }
 
 /**
- * @brief Inserts a new node into the hashtable.
+ * @brief Grows a hashtable in one step so that it holds a number of entries
+ * without further resizing. Any in-flight incremental resize is completed. A
+ * table that is already large enough is left at its size. Like
+ * ht_create_reserve(), the reservation also becomes the floor that deletes
+ * never shrink the table below.
  *
- * @param pp_ht A pointer to the pointer to the hashtable.
- * @param p_key Char pointer to the p_key of the new node.
- * @param p_value Void pointer to the value of the new node.
+ * @param p_ht Pointer to the hashtable.
+ * @param expected_entries Number of entries the table is expected to hold.
  * @return error_t On success, returns 0, else non zero error.
  */
-error_t ht_insert (ht_t ** pp_ht, char * p_key, void * p_value)
+error_t ht_reserve (ht_t * p_ht, size_t expected_entries)
 {
     error_t retval = E_GENERAL;
 
-    if (NULL == pp_ht || NULL == *pp_ht)
+    if (NULL == p_ht)
     {
         retval = E_NULL_PTR;
         goto EXIT;
     }
 
-    node_t * p_new_node = node_create(p_key, p_value);
+    uint32_t reserved_index
+        = ht_class_for_count(p_ht, p_ht->min_index, expected_entries);
 
-    if (NULL == p_new_node)
+    retval = ht_resize_full(p_ht,
+                            (reserved_index > p_ht->prime_index)
+                                ? reserved_index
+                                : p_ht->prime_index);
+
+    if (E_SUCCESS == retval)
+    {
+        p_ht->min_index = reserved_index;
+    }
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Shrinks a hashtable to the smallest size class that holds its
+ * entries and compacts the nodes and owned keys into fresh memory, so the
+ * blocks left sparse by deletes are given back. This goes below the size the
+ * table was created or reserved with, and the floor for automatic shrinking
+ * is lowered to the new size class if it was above it.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @return error_t On success, returns 0, else non zero error. On error the
+ * table is unchanged apart from possibly having been shrunk.
+ */
+error_t ht_shrink_to_fit (ht_t * p_ht)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht)
     {
         retval = E_NULL_PTR;
         goto EXIT;
     }
 
-    uint32_t hash  = hash_str(p_key);
-    uint32_t index = hash % (*pp_ht)->capacity;
+    // relink into the smaller array first so the compaction walks fewer
+    // buckets
+    retval = ht_resize_full(p_ht, ht_class_for_count(p_ht, 0, p_ht->size));
 
-    if (NULL == (*pp_ht)->pp_items[index])
+    if (E_SUCCESS != retval)
     {
-        (*pp_ht)->size++;
+        goto EXIT;
     }
-    else
+
+    // an explicit shrink drops any reservation, so the floor never sits
+    // above the current size class; a lower floor is left as it is
+    if (p_ht->min_index > p_ht->prime_index)
     {
-        p_new_node->p_next = (*pp_ht)->pp_items[index];
+        p_ht->min_index = p_ht->prime_index;
     }
 
-    (*pp_ht)->pp_items[index] = p_new_node;
-    // typecast to float to avoid integer division
-    float load_factor = (float)(*pp_ht)->size / (*pp_ht)->capacity;
+    retval = ht_compact_nodes(p_ht);
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Takes a snapshot of a hashtable's shape, memory use and resize
+ * history. Every bucket is visited, so this is meant for occasional
+ * inspection rather than the hot path.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_stats Pointer to the statistics to be filled in.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t ht_stats (ht_t * p_ht, ht_stats_t * p_stats)
+{
+    error_t   retval      = E_GENERAL;
+    size_t    probes      = 0;
+    node_t ** pp_arrays[] = { NULL, NULL };
+    size_t    lengths[]   = { 0, 0 };
 
-    // if load factor is greater than 0.8, resize the hashtable
-    if (load_factor > 0.8)
+    if (NULL == p_ht || NULL == p_stats)
     {
-        ht_t * p_new_ht = ht_create(((*pp_ht)->prime_index) + 1);
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    memset(p_stats, 0, sizeof(ht_stats_t));
+    pp_arrays[0] = p_ht->pp_items;
+    pp_arrays[1] = p_ht->pp_old_items;
+    lengths[0]   = p_ht->capacity;
+    lengths[1]   = (NULL != p_ht->pp_old_items) ? p_ht->old_capacity : 0;
 
-        for (uint32_t cap_idx = 0; cap_idx < (*pp_ht)->capacity; cap_idx++)
+    for (int array_idx = 0; array_idx < 2; array_idx++)
+    {
+        for (size_t bucket_idx = 0; bucket_idx < lengths[array_idx];
+             bucket_idx++)
         {
-            node_t * p_node = (*pp_ht)->pp_items[cap_idx];
+            size_t chain = 0;
 
-            while (p_node != NULL)
+            for (node_t * p_node = pp_arrays[array_idx][bucket_idx];
+                 NULL != p_node;
+                 p_node = p_node->p_next)
             {
-                retval = ht_insert(&p_new_ht, p_node->p_key, p_node->p_value);
-
-                if (E_SUCCESS != retval)
-                {
-                    fprintf(stderr,
-                            "Could not insert into new hashtable: %s\n",
-                            error_desc_t[retval].desc);
-                    goto EXIT;
-                }
+                chain++;
+                probes += chain;
+            }
 
-                p_node = p_node->p_next;
+            if (chain > p_stats->max_chain)
+            {
+                p_stats->max_chain = chain;
             }
+
+            p_stats->chain_lengths[(HT_STATS_CHAIN_SLOTS > chain)
+                                       ? chain
+                                       : HT_STATS_CHAIN_SLOTS - 1]++;
         }
+    }
+
+    p_stats->entries      = p_ht->size;
+    p_stats->used_buckets = p_ht->used_buckets;
+    p_stats->capacity     = lengths[0];
+    p_stats->old_capacity = lengths[1];
+    p_stats->load_factor  = (double)p_ht->size / p_ht->capacity;
+    p_stats->mean_chain   = p_ht->used_buckets
+                                ? (double)p_ht->size / p_ht->used_buckets
+                                : 0;
+    p_stats->mean_hit_probes
+        = p_ht->size ? (double)probes / p_ht->size : 0;
+    p_stats->bucket_bytes = (lengths[0] + lengths[1]) * sizeof(node_t *);
+    p_stats->node_bytes   = p_ht->node_pool.block_bytes;
+    p_stats->key_bytes    = p_ht->key_arena.chunk_bytes;
+    p_stats->resize_count = p_ht->resize_count;
+    p_stats->resize_ns    = p_ht->resize_ns;
+    retval                = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Sums the operation counters and latency samples of every shard. The
+ * loads are relaxed, so a snapshot taken while other threads are writing may
+ * be slightly behind but never torn.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_metrics Pointer to the structure to be filled in.
+ * @return error_t E_NOT_SUPPORTED, with p_metrics zeroed, unless the table
+ * was built with HT_ENABLE_METRICS.
+ */
+error_t ht_metrics (ht_t * p_ht, ht_metrics_t * p_metrics)
+{
+    error_t retval = E_GENERAL;
 
-        retval = ht_destroy(*pp_ht);
+    if (NULL == p_ht || NULL == p_metrics)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
 
-        if (E_SUCCESS != retval)
+    memset(p_metrics, 0, sizeof(ht_metrics_t));
+
+#ifdef HT_ENABLE_METRICS
+    for (int shard_idx = 0; shard_idx < HT_METRICS_SHARDS; shard_idx++)
+    {
+        ht_metrics_shard_t * p_shard = &p_ht->p_metrics[shard_idx];
+
+        for (int metric = 0; metric < HT_METRIC_COUNT; metric++)
         {
-            fprintf(stderr,
-                    "Could not destroy old hashtable: %s\n",
-                    error_desc_t[retval].desc);
-            goto EXIT;
+            p_metrics->counters[metric] += atomic_load_explicit(
+                &p_shard->counters[metric], memory_order_relaxed);
         }
 
-        *pp_ht = p_new_ht;
+        for (int op = 0; op < HT_SAMPLE_OP_COUNT; op++)
+        {
+            uint64_t max_ns = atomic_load_explicit(&p_shard->sample_max_ns[op],
+                                                   memory_order_relaxed);
+
+            p_metrics->samples[op] += atomic_load_explicit(
+                &p_shard->samples[op], memory_order_relaxed);
+            p_metrics->sample_ns[op] += atomic_load_explicit(
+                &p_shard->sample_ns[op], memory_order_relaxed);
+
+            if (max_ns > p_metrics->sample_max_ns[op])
+            {
+                p_metrics->sample_max_ns[op] = max_ns;
+            }
+        }
     }
 
     retval = E_SUCCESS;
+#else
+    retval = E_NOT_SUPPORTED;
+#endif
+
 EXIT:
     return (retval);
 }
 
 /**
- * @brief Deletes a node from the hashtable.
+ * @brief Inserts a new node into the hashtable.
  *
- * @param p_ht Pointer to the hashtable
- * @param p_key Char pointer to the p_key of the node to be deleted.
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Char pointer to the p_key of the new node.
+ * @param p_value Void pointer to the value of the new node.
  * @return error_t On success, returns 0, else non zero error.
  */
-error_t ht_delete (ht_t * p_ht, char * p_key)
+error_t ht_insert (ht_t ** pp_ht, char * p_key, void * p_value)
+{
+    if (NULL == p_key)
+    {
+        return (E_NULL_PTR);
+    }
+
+    return (ht_insert_n(pp_ht, p_key, strlen(p_key), p_value));
+}
+
+/**
+ * @brief Inserts a new node with a binary key into the hashtable.
+ *
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Pointer to the key bytes, which need not be NUL terminated.
+ * @param key_len Length of the key in bytes, at most HT_KEY_LEN_MAX.
+ * @param p_value Void pointer to the value of the new node.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t ht_insert_n (ht_t **      pp_ht,
+                     const void * p_key,
+                     size_t       key_len,
+                     void *       p_value)
 {
     error_t retval = E_GENERAL;
 
-    if (NULL == p_ht)
+    if (NULL == pp_ht || NULL == *pp_ht || NULL == p_key)
     {
         retval = E_NULL_PTR;
         goto EXIT;
     }
 
-    if (NULL == p_key)
+    if (HT_KEY_LEN_MAX < key_len)
     {
-        retval = E_NULL_PTR;
+        retval = E_HASHTABLE_INSERT;
         goto EXIT;
     }
 
-    uint32_t  hash  = hash_str(p_key);
-    uint32_t  index = hash % p_ht->capacity;
-    node_t ** node  = &(p_ht->pp_items[index]);
+    HT_SAMPLE_BEGIN(*pp_ht);
 
-    while (NULL != *node)
-    {
-        if (0 == strncmp(p_key, (*node)->p_key, strlen(p_key)))
-        {
-            printf("Found node to delete\n");
-            node_t * to_delete = *node;
-            *node              = (*node)->p_next;
-            free(to_delete);
-            p_ht->size--;
-            retval = E_SUCCESS;
-            goto EXIT;
-        }
+    uint32_t hash       = hash_key(*pp_ht, p_key, key_len);
+    node_t * p_new_node = node_create(*pp_ht, p_key, key_len, p_value, hash);
 
-        node = &((*node)->p_next);
+    if (NULL == p_new_node)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
     }
 
-    retval = E_NODE_NOT_FOUND;
+    ht_migrate_key(*pp_ht, hash);
+    ht_migrate_step(*pp_ht);
+
+    uint32_t index = ht_bucket_index(
+        *pp_ht, hash, (*pp_ht)->capacity, (*pp_ht)->fastmod_m);
+
+    ht_link_node(*pp_ht, p_new_node, index);
+    HT_SAMPLE_END(*pp_ht, HT_SAMPLE_INSERT);
+    retval = E_SUCCESS;
 EXIT:
     return (retval);
 }
 
 /**
- * @brief Searches the hashtable for a p_key.
+ * @brief Inserts a key, or replaces the value of the newest entry for it in
+ * place if it is already present.
  *
- * @param p_ht Pointer to the hashtable.
- * @param p_key Char pointer to the p_key to be searched for.
- * @return void* On success, returns a pointer to the value of the p_key, else
- * NULL.
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Char pointer to the key.
+ * @param p_value Void pointer to the value to be stored.
+ * @return error_t On success, returns 0, else non zero error.
  */
-void * ht_search (ht_t * p_ht, char * p_key)
+error_t ht_upsert (ht_t ** pp_ht, char * p_key, void * p_value)
 {
-    void * retval = NULL;
+    error_t retval  = E_GENERAL;
+    int     created = 0;
 
-    if (NULL == p_ht)
+    if (NULL == pp_ht || NULL == *pp_ht || NULL == p_key)
     {
+        retval = E_NULL_PTR;
         goto EXIT;
     }
 
-    uint32_t hash  = hash_str(p_key);
-    uint32_t index = hash % p_ht->capacity;
-    node_t * node  = p_ht->pp_items[index];
+    node_t * p_node
+        = ht_find_or_insert(pp_ht, p_key, strlen(p_key), p_value, &created);
 
-    while (NULL != node)
+    if (NULL == p_node)
     {
-        if (0 == strcmp(p_key, node->p_key))
-        {
-            retval = node->p_value;
-            goto EXIT;
-        }
-
-        node = node->p_next;
+        retval = E_HASHTABLE_INSERT;
+        goto EXIT;
     }
 
+    p_node->p_value = p_value;
+    retval          = E_SUCCESS;
+
 EXIT:
     return (retval);
 }
 
 /**
- * @brief A private function to create a new node
+ * @brief Inserts a key only if it is not already present.
  *
- * @param p_key Pointer to the p_key of the new node.
- * @param p_value Pointer to the value of the new node.
- * @return node_t* On success, returns a pointer to the newly created node, else
- * NULL;
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Char pointer to the key.
+ * @param p_value Void pointer to the value of the new entry.
+ * @return error_t On success, returns 0, E_KEY_EXISTS if the key is already
+ * present, else non zero error.
  */
-node_t * node_create (char * p_key, void * p_value)
+error_t ht_insert_if_absent (ht_t ** pp_ht, char * p_key, void * p_value)
 {
-    node_t * new_node = malloc(sizeof(node_t));
+    error_t retval  = E_GENERAL;
+    int     created = 0;
 
-    if (new_node)
+    if (NULL == pp_ht || NULL == *pp_ht || NULL == p_key)
     {
-        new_node->p_key   = p_key;
-        new_node->p_value = p_value;
-        new_node->p_next  = NULL;
+        retval = E_NULL_PTR;
+        goto EXIT;
     }
 
-    return (new_node);
-};
+    node_t * p_node
+        = ht_find_or_insert(pp_ht, p_key, strlen(p_key), p_value, &created);
+
+    if (NULL == p_node)
+    {
+        retval = E_HASHTABLE_INSERT;
+        goto EXIT;
+    }
+
+    retval = created ? E_SUCCESS : E_KEY_EXISTS;
+
+EXIT:
+    return (retval);
+}
 
 /**
- * @brief Hashes a string p_key.
+ * @brief Returns the value stored for a key, inserting the key with p_value
+ * first if it is not present.
  *
- * @param p_key Pointer to the string p_key to be hashed.
- * @return uint32_t Returns the hash value of the p_key.
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Char pointer to the key.
+ * @param p_value Void pointer to the value stored if the key is absent.
+ * @param pp_stored Receives the value stored for the key after the call.
+ * @return error_t On success, returns 0, else non zero error.
  */
-uint32_t hash_str (char * p_key)
+error_t ht_get_or_insert (ht_t ** pp_ht,
+                          char *   p_key,
+                          void *   p_value,
+                          void **  pp_stored)
 {
-    uint32_t hash = murmurhash(p_key, strlen(p_key), 0);
-    return (hash);
+    error_t retval  = E_GENERAL;
+    int     created = 0;
+
+    if (NULL == pp_ht || NULL == *pp_ht || NULL == p_key || NULL == pp_stored)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    node_t * p_node
+        = ht_find_or_insert(pp_ht, p_key, strlen(p_key), p_value, &created);
+
+    if (NULL == p_node)
+    {
+        retval = E_HASHTABLE_INSERT;
+        goto EXIT;
+    }
+
+    *pp_stored = p_node->p_value;
+    retval     = E_SUCCESS;
+
+EXIT:
+    return (retval);
 }
 
-// NOLINTBEGIN
 /**
- * @brief An implementation of MurmurHash3.
- * Credit: https://github.com/jwerle/murmurhash.c
+ * @brief Inserts an array of key/value pairs. The table is resized once, up
+ * front, to the size class that holds all of them, and the pairs are then
+ * linked straight into their buckets without any per entry load check, so a
+ * large load never passes through the intermediate size classes. Unlike
+ * ht_reserve() this sizes for entries actually present, so it does not raise
+ * the floor deletes shrink down to.
  *
- * @param p_key Pointer to the p_key to be hashed.
- * @param len Length of the p_key.
- * @param seed Seed value for the hash.
- * @return uint32_t Returns the hash value of the p_key.
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_pairs Array of count pairs. Keys follow the rules of ht_insert().
+ * @param count Number of pairs.
+ * @return error_t On success, returns 0, else non zero error. If the table
+ * cannot be resized nothing is inserted, otherwise on error the pairs before
+ * the failing one remain inserted.
  */
+error_t ht_bulk_load (ht_t ** pp_ht, const ht_kv_t * p_pairs, size_t count)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == pp_ht || NULL == *pp_ht || (0 != count && NULL == p_pairs))
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    ht_t *   p_ht        = *pp_ht;
+    uint32_t class_index
+        = ht_class_for_count(p_ht, p_ht->prime_index, p_ht->size + count);
+
+    // relinks any in-flight migration away even when the class is unchanged;
+    // without the larger array the unchecked links below would overload it
+    retval = ht_resize_full(p_ht, class_index);
+
+    if (E_SUCCESS != retval)
+    {
+        goto EXIT;
+    }
+
+    for (size_t pair_idx = 0; pair_idx < count; pair_idx++)
+    {
+        char * p_key = p_pairs[pair_idx].p_key;
+
+        if (NULL == p_key)
+        {
+            retval = E_NULL_PTR;
+            goto EXIT;
+        }
+
+        size_t   key_len    = strlen(p_key);
+        uint32_t hash       = hash_key(p_ht, p_key, key_len);
+        node_t * p_new_node = node_create(
+            p_ht, p_key, key_len, p_pairs[pair_idx].p_value, hash);
+
+        if (NULL == p_new_node)
+        {
+            retval = E_NULL_PTR;
+            goto EXIT;
+        }
 
-uint32_t murmurhash (const void * key_ptr, int length, uint32_t seed)
-{
-    uint32_t         const1     = 0xcc9e2d51;
-    uint32_t         const2     = 0x1b873593;
-    uint32_t         shift1     = 15;
-    uint32_t         shift2     = 13;
-    uint32_t         multiplier = 5;
-    uint32_t         adder      = 0xe6546b64;
-    uint32_t         hash       = 0;
-    uint32_t         key_chunk  = 0;
-    uint8_t *        data = (uint8_t *)key_ptr; // 32 bit extract from `p_key'
-    const uint32_t * chunks_ptr = NULL;
-    const uint8_t *  tail_ptr   = NULL; // tail - last 8 bytes
-    int              index      = 0;
-    int              chunk_len  = length / 4; // chunk length
-    hash                        = seed;
-    chunks_ptr                  = (const uint32_t *)(data + chunk_len * 4);
-    tail_ptr                    = (const uint8_t *)(data + chunk_len * 4);
-
-    // for each 4 byte chunk of `p_key'
-    for (index = -chunk_len; index != 0; ++index)
-    {
-        // next 4 byte chunk of `p_key'
-        key_chunk = chunks_ptr[index];
-        // encode next 4 byte chunk of `p_key'
-        key_chunk *= const1;
-        key_chunk = (key_chunk << shift1) | (key_chunk >> (32 - shift1));
-        key_chunk *= const2;
-        // append to hash
-        hash ^= key_chunk;
-        hash = (hash << shift2) | (hash >> (32 - shift2));
-        hash = hash * multiplier + adder;
-    }
-
-    key_chunk = 0;
-
-// In this switch case, we want the cases to fall through.
-#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
-    switch (length & 3)
-    { // `len % 4'
-        case 3:
-            key_chunk ^= (tail_ptr[2] << 16);
-        case 2:
-            key_chunk ^= (tail_ptr[1] << 8);
-        case 1:
-            key_chunk ^= tail_ptr[0];
-            key_chunk *= const1;
-            key_chunk = (key_chunk << shift1) | (key_chunk >> (32 - shift1));
-            key_chunk *= const2;
-            hash ^= key_chunk;
-    }
-
-    hash ^= length;
-    hash ^= (hash >> 16);
-    hash *= 0x85ebca6b;
-    hash ^= (hash >> 13);
-    hash *= 0xc2b2ae35;
-    hash ^= (hash >> 16);
-
-    return hash;
-}
-
-// NOLINTEND
+        uint32_t index
+            = ht_bucket_index(p_ht, hash, p_ht->capacity, p_ht->fastmod_m);
+
+        if (NULL == p_ht->pp_items[index])
+        {
+            p_ht->used_buckets++;
+        }
+
+        p_new_node->p_next    = p_ht->pp_items[index];
+        p_ht->pp_items[index] = p_new_node;
+        p_ht->size++;
+        HT_METRIC_ADD(p_ht, HT_METRIC_INSERTS, 1);
+    }
+
+    retval = E_SUCCESS;
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Updates the value of a key in place through a callback, creating
+ * the entry with a NULL value first if the key is absent. The key is hashed
+ * and its chain walked only once, so read-modify-write workloads such as
+ * counters need a single probe.
+ *
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Char pointer to the key.
+ * @param update_fn Callback invoked once with a pointer to the stored value.
+ * It must not access the hashtable.
+ * @param p_ctx Opaque pointer handed to update_fn.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t ht_update_with (ht_t **        pp_ht,
+                        char *         p_key,
+                        ht_update_fn_t update_fn,
+                        void *         p_ctx)
+{
+    error_t retval  = E_GENERAL;
+    int     created = 0;
+
+    if (NULL == pp_ht || NULL == *pp_ht || NULL == p_key
+        || NULL == update_fn)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    node_t * p_node
+        = ht_find_or_insert(pp_ht, p_key, strlen(p_key), NULL, &created);
+
+    if (NULL == p_node)
+    {
+        retval = E_HASHTABLE_INSERT;
+        goto EXIT;
+    }
+
+    update_fn(&p_node->p_value, created, p_ctx);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Deletes a node from the hashtable.
+ *
+ * @param p_ht Pointer to the hashtable
+ * @param p_key Char pointer to the p_key of the node to be deleted.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t ht_delete (ht_t * p_ht, char * p_key)
+{
+    if (NULL == p_key)
+    {
+        return (E_NULL_PTR);
+    }
+
+    return (ht_delete_n(p_ht, p_key, strlen(p_key)));
+}
+
+/**
+ * @brief Deletes the node with a binary key from the hashtable.
+ *
+ * @param p_ht Pointer to the hashtable
+ * @param p_key Pointer to the key bytes.
+ * @param key_len Length of the key in bytes, at most HT_KEY_LEN_MAX.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t ht_delete_n (ht_t * p_ht, const void * p_key, size_t key_len)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    if (NULL == p_key)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    // no such key can be stored, and the hash functions take an int length
+    if (HT_KEY_LEN_MAX < key_len)
+    {
+        retval = E_HASHTABLE_DELETE;
+        goto EXIT;
+    }
+
+    HT_SAMPLE_BEGIN(p_ht);
+
+    uint32_t hash = hash_key(p_ht, p_key, key_len);
+
+    ht_migrate_key(p_ht, hash);
+    ht_migrate_step(p_ht);
+
+    uint32_t index
+        = ht_bucket_index(p_ht, hash, p_ht->capacity, p_ht->fastmod_m);
+    node_t ** node  = &(p_ht->pp_items[index]);
+    uint64_t  steps = 0;
+
+    while (NULL != *node)
+    {
+        steps++;
+
+        if (node_matches(*node, p_key, key_len, hash))
+        {
+            HT_METRIC_ADD(p_ht, HT_METRIC_CHAIN_STEPS, steps);
+            HT_METRIC_ADD(p_ht, HT_METRIC_DELETES, 1);
+
+            node_t * to_delete = *node;
+            *node              = (*node)->p_next;
+            node_free(p_ht, to_delete);
+            p_ht->size--;
+            retval = E_SUCCESS;
+
+            if (NULL == p_ht->pp_items[index])
+            {
+                p_ht->used_buckets--;
+            }
+
+            // shrink to a class that leaves the table half as full as the
+            // maximum load factor allows, so it sits clear of both thresholds
+            if ((p_ht->min_index < p_ht->prime_index)
+                && ((double)p_ht->size / p_ht->capacity
+                    < p_ht->max_load_factor / HT_SHRINK_DIVISOR))
+            {
+                ht_shrink_auto(p_ht);
+            }
+
+            HT_SAMPLE_END(p_ht, HT_SAMPLE_DELETE);
+            goto EXIT;
+        }
+
+        node = &((*node)->p_next);
+    }
+
+    HT_METRIC_ADD(p_ht, HT_METRIC_CHAIN_STEPS, steps);
+    HT_METRIC_ADD(p_ht, HT_METRIC_DELETE_MISSES, 1);
+    HT_SAMPLE_END(p_ht, HT_SAMPLE_DELETE);
+    retval = E_NODE_NOT_FOUND;
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Searches the hashtable for a p_key.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_key Char pointer to the p_key to be searched for.
+ * @return void* On success, returns a pointer to the value of the p_key, else
+ * NULL.
+ */
+void * ht_search (ht_t * p_ht, char * p_key)
+{
+    if (NULL == p_key)
+    {
+        return (NULL);
+    }
+
+    return (ht_search_n(p_ht, p_key, strlen(p_key)));
+}
+
+/**
+ * @brief Searches the hashtable for a binary key.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_key Pointer to the key bytes.
+ * @param key_len Length of the key in bytes, at most HT_KEY_LEN_MAX.
+ * @return void* On success, returns a pointer to the value of the key, else
+ * NULL.
+ */
+void * ht_search_n (ht_t * p_ht, const void * p_key, size_t key_len)
+{
+    void * retval = NULL;
+
+    if (NULL == p_ht || NULL == p_key || HT_KEY_LEN_MAX < key_len)
+    {
+        goto EXIT;
+    }
+
+    HT_SAMPLE_BEGIN(p_ht);
+
+    uint32_t hash = hash_key(p_ht, p_key, key_len);
+
+    ht_migrate_key(p_ht, hash);
+    ht_migrate_step(p_ht);
+
+    uint32_t index
+        = ht_bucket_index(p_ht, hash, p_ht->capacity, p_ht->fastmod_m);
+    node_t * node  = p_ht->pp_items[index];
+    uint64_t steps = 0;
+
+    while (NULL != node)
+    {
+        steps++;
+
+        if (node_matches(node, p_key, key_len, hash))
+        {
+            retval = node->p_value;
+            HT_METRIC_ADD(p_ht, HT_METRIC_CHAIN_STEPS, steps);
+            HT_METRIC_ADD(p_ht, HT_METRIC_HITS, 1);
+            HT_SAMPLE_END(p_ht, HT_SAMPLE_SEARCH);
+            goto EXIT;
+        }
+
+        node = node->p_next;
+    }
+
+    HT_METRIC_ADD(p_ht, HT_METRIC_CHAIN_STEPS, steps);
+    HT_METRIC_ADD(p_ht, HT_METRIC_MISSES, 1);
+    HT_SAMPLE_END(p_ht, HT_SAMPLE_SEARCH);
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Searches the hashtable for many keys at once. Keys are processed
+ * HT_BATCH_CHUNK at a time: all of them are hashed and their buckets
+ * prefetched, then the head nodes are prefetched, and only then are the
+ * chains walked, so the cache misses of a chunk overlap instead of being paid
+ * one after another.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param pp_keys Array of count keys. NULL entries are never found.
+ * @param count Number of keys.
+ * @param pp_values Array receiving the value of each key, or NULL for a key
+ * that is not in the table.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t ht_search_batch (ht_t *  p_ht,
+                         char ** pp_keys,
+                         size_t  count,
+                         void ** pp_values)
+{
+    error_t  retval = E_GENERAL;
+    size_t   key_lens[HT_BATCH_CHUNK];
+    uint32_t hashes[HT_BATCH_CHUNK];
+    uint32_t indexes[HT_BATCH_CHUNK];
+    node_t * p_heads[HT_BATCH_CHUNK];
+    uint64_t steps  = 0;
+    uint64_t hits   = 0;
+
+    if (NULL == p_ht || (0 != count && (NULL == pp_keys || NULL == pp_values)))
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    for (size_t base = 0; base < count; base += HT_BATCH_CHUNK)
+    {
+        size_t    chunk    = count - base;
+        char **   pp_chunk = pp_keys + base;
+        node_t ** pp_items = NULL;
+
+        if (HT_BATCH_CHUNK < chunk)
+        {
+            chunk = HT_BATCH_CHUNK;
+        }
+
+        for (size_t key_idx = 0; key_idx < chunk; key_idx++)
+        {
+            if (NULL != pp_chunk[key_idx])
+            {
+                key_lens[key_idx] = strlen(pp_chunk[key_idx]);
+                hashes[key_idx]
+                    = hash_key(p_ht, pp_chunk[key_idx], key_lens[key_idx]);
+                ht_migrate_key(p_ht, hashes[key_idx]);
+            }
+        }
+
+        // migration only ever moves nodes into the active array, and nothing
+        // below can grow the table, so these indexes stay valid
+        ht_migrate_step(p_ht);
+        pp_items = p_ht->pp_items;
+
+        for (size_t key_idx = 0; key_idx < chunk; key_idx++)
+        {
+            if (NULL != pp_chunk[key_idx])
+            {
+                indexes[key_idx] = ht_bucket_index(
+                    p_ht, hashes[key_idx], p_ht->capacity, p_ht->fastmod_m);
+                __builtin_prefetch(&pp_items[indexes[key_idx]], 0, 1);
+            }
+        }
+
+        for (size_t key_idx = 0; key_idx < chunk; key_idx++)
+        {
+            p_heads[key_idx] = NULL;
+
+            if (NULL != pp_chunk[key_idx])
+            {
+                p_heads[key_idx] = pp_items[indexes[key_idx]];
+
+                if (NULL != p_heads[key_idx])
+                {
+                    __builtin_prefetch(p_heads[key_idx], 0, 1);
+                }
+            }
+        }
+
+        for (size_t key_idx = 0; key_idx < chunk; key_idx++)
+        {
+            node_t * node = p_heads[key_idx];
+
+            pp_values[base + key_idx] = NULL;
+
+            while (NULL != node)
+            {
+                steps++;
+
+                if (node_matches(node,
+                                 pp_chunk[key_idx],
+                                 key_lens[key_idx],
+                                 hashes[key_idx]))
+                {
+                    pp_values[base + key_idx] = node->p_value;
+                    hits++;
+                    break;
+                }
+
+                node = node->p_next;
+            }
+        }
+    }
+
+    // counted once per batch rather than once per key
+    HT_METRIC_ADD(p_ht, HT_METRIC_CHAIN_STEPS, steps);
+    HT_METRIC_ADD(p_ht, HT_METRIC_HITS, hits);
+    HT_METRIC_ADD(p_ht, HT_METRIC_MISSES, count - hits);
+    retval = E_SUCCESS;
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that returns the newest node holding a key, or
+ * links in a new node for it with p_value. The key is hashed once and its
+ * chain walked once either way.
+ *
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Pointer to the key bytes.
+ * @param key_len Length of the key in bytes.
+ * @param p_value Value of the node if one has to be created.
+ * @param p_created Set to non zero if the node was created.
+ * @return node_t* The node, or NULL on error. Nodes are never moved by a
+ * resize, so the pointer stays valid until the key is deleted.
+ */
+static node_t * ht_find_or_insert (ht_t **      pp_ht,
+                                   const void * p_key,
+                                   size_t       key_len,
+                                   void *       p_value,
+                                   int *        p_created)
+{
+    node_t * p_node = NULL;
+
+    *p_created = 0;
+
+    if (NULL == pp_ht || NULL == *pp_ht || HT_KEY_LEN_MAX < key_len)
+    {
+        goto EXIT;
+    }
+
+    ht_t *   p_ht = *pp_ht;
+    uint32_t hash = hash_key(p_ht, p_key, key_len);
+
+    ht_migrate_key(p_ht, hash);
+    ht_migrate_step(p_ht);
+
+    uint32_t index
+        = ht_bucket_index(p_ht, hash, p_ht->capacity, p_ht->fastmod_m);
+    uint64_t steps = 0;
+
+    for (p_node = p_ht->pp_items[index]; NULL != p_node;
+         p_node = p_node->p_next)
+    {
+        steps++;
+
+        if (node_matches(p_node, p_key, key_len, hash))
+        {
+            HT_METRIC_ADD(p_ht, HT_METRIC_CHAIN_STEPS, steps);
+            HT_METRIC_ADD(p_ht, HT_METRIC_HITS, 1);
+            goto EXIT;
+        }
+    }
+
+    // a miss here is counted as the insert ht_link_node() records
+    HT_METRIC_ADD(p_ht, HT_METRIC_CHAIN_STEPS, steps);
+    p_node = node_create(p_ht, p_key, key_len, p_value, hash);
+
+    if (NULL != p_node)
+    {
+        ht_link_node(p_ht, p_node, index);
+        *p_created = 1;
+    }
+
+EXIT:
+    return (p_node);
+}
+
+/**
+ * @brief A private function that prepends a new node to its bucket in the
+ * active bucket array and grows the table if that takes it over its maximum
+ * load factor.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_node Pointer to the node.
+ * @param index Index of the node's bucket in the active bucket array.
+ */
+static void ht_link_node (ht_t * p_ht, node_t * p_node, uint32_t index)
+{
+    if (NULL == p_ht->pp_items[index])
+    {
+        p_ht->used_buckets++;
+    }
+
+    p_node->p_next        = p_ht->pp_items[index];
+    p_ht->pp_items[index] = p_node;
+    p_ht->size++;
+    HT_METRIC_ADD(p_ht, HT_METRIC_INSERTS, 1);
+    // typecast to double to avoid integer division
+    double load_factor = (double)p_ht->size / p_ht->capacity;
+
+    // if load factor is greater than the maximum, resize the hashtable
+    if (load_factor > p_ht->max_load_factor)
+    {
+        if (HT_PRIME_COUNT <= p_ht->prime_index + 1)
+        {
+            return;
+        }
+
+        if (HT_RESIZE_INCREMENTAL == p_ht->resize_mode)
+        {
+            ht_resize_incremental(p_ht, p_ht->prime_index + 1);
+        }
+        else
+        {
+            ht_resize_full(p_ht, p_ht->prime_index + 1);
+        }
+    }
+}
+
+/**
+ * @brief A private function that returns the bucket count of a size class
+ * under the table's capacity policy.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param class_index Index of the size class.
+ * @return size_t The bucket count.
+ */
+static size_t ht_class_capacity (ht_t * p_ht, uint32_t class_index)
+{
+    if (HT_CAPACITY_POW2 == p_ht->capacity_policy)
+    {
+        return ((size_t)64 << class_index);
+    }
+
+    return (g_primes[class_index]);
+}
+
+/**
+ * @brief A private function that precomputes the fastmod multiplier of a
+ * bucket count, ceil(2^64 / capacity).
+ *
+ * @param capacity The bucket count.
+ * @return uint64_t The multiplier.
+ */
+static uint64_t ht_fastmod_m (size_t capacity)
+{
+    return ((UINT64_C(0xFFFFFFFFFFFFFFFF) / capacity) + 1);
+}
+
+/**
+ * @brief A private function that reduces a hash to a bucket index.
+ * Power of two tables take the top bits of hash * 2^32 / phi, a final mixing
+ * step so that weak low hash bits do not cluster. Prime tables compute
+ * hash % capacity as a multiply (Lemire, "Faster Remainder by Direct
+ * Computation"), which is exact for any 32 bit hash and capacity.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param hash Hash of the key.
+ * @param capacity Bucket count of the array being indexed.
+ * @param fastmod_m Multiplier from ht_fastmod_m() for that bucket count.
+ * @return uint32_t The bucket index.
+ */
+static uint32_t ht_bucket_index (ht_t *   p_ht,
+                                 uint32_t hash,
+                                 size_t   capacity,
+                                 uint64_t fastmod_m)
+{
+    if (HT_CAPACITY_POW2 == p_ht->capacity_policy)
+    {
+        return ((uint32_t)(hash * UINT32_C(0x9E3779B1))
+                >> (32 - __builtin_ctzll(capacity)));
+    }
+
+    uint64_t lowbits = fastmod_m * hash;
+
+    return ((uint32_t)(((__uint128_t)lowbits * capacity) >> 64));
+}
+
+/**
+ * @brief A private function that returns the smallest size class, no smaller
+ * than min_index, that holds count entries without going over the table's
+ * maximum load factor.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param min_index Index of the smallest size class to consider.
+ * @param count Number of entries the table has to hold.
+ * @return uint32_t Index of the size class.
+ */
+static uint32_t ht_class_for_count (ht_t *   p_ht,
+                                    uint32_t min_index,
+                                    size_t   count)
+{
+    uint32_t class_index = min_index;
+
+    while ((HT_PRIME_COUNT > class_index + 1)
+           && ((double)count > (double)ht_class_capacity(p_ht, class_index)
+                                  * p_ht->max_load_factor))
+    {
+        class_index++;
+    }
+
+    return (class_index);
+}
+
+/**
+ * @brief A private function that resizes the hashtable to a size class in one
+ * go, completing any in-flight migration first. The existing nodes are
+ * relinked into the new bucket array, so the resize neither allocates nor
+ * frees any node.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param class_index Index of the size class to resize to.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t ht_resize_full (ht_t * p_ht, uint32_t class_index)
+{
+    ht_migrate_finish(p_ht);
+
+    if (class_index == p_ht->prime_index)
+    {
+        return (E_SUCCESS);
+    }
+
+    uint64_t  start        = ht_now_ns();
+    size_t    new_capacity = ht_class_capacity(p_ht, class_index);
+    node_t ** pp_new_items = calloc(new_capacity, sizeof(node_t *));
+
+    if (NULL == pp_new_items)
+    {
+        perror("Failed to calloc memory for hashtable items\n");
+        return (E_GENERAL);
+    }
+
+    node_t ** pp_old_items = p_ht->pp_items;
+    size_t    old_capacity = p_ht->capacity;
+
+    p_ht->pp_items     = pp_new_items;
+    p_ht->capacity     = new_capacity;
+    p_ht->fastmod_m    = ht_fastmod_m(new_capacity);
+    p_ht->used_buckets = 0;
+    p_ht->prime_index  = class_index;
+
+    for (size_t old_idx = 0; old_idx < old_capacity; old_idx++)
+    {
+        ht_relink_chain(p_ht, pp_old_items[old_idx]);
+    }
+
+    free(pp_old_items);
+    p_ht->resize_count++;
+    HT_METRIC_ADD(p_ht, HT_METRIC_RESIZES, 1);
+    p_ht->resize_ns += ht_now_ns() - start;
+
+    return (E_SUCCESS);
+}
+
+/**
+ * @brief A private function that starts an incremental resize, growing or
+ * shrinking. The new bucket array becomes the active one and the current
+ * array is kept around until every bucket in it has been moved over.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param class_index Index of the size class to resize to.
+ */
+static void ht_resize_incremental (ht_t * p_ht, uint32_t class_index)
+{
+    // only one migration may be in flight at a time
+    ht_migrate_finish(p_ht);
+
+    uint64_t  start        = ht_now_ns();
+    size_t    new_capacity = ht_class_capacity(p_ht, class_index);
+    node_t ** pp_new_items = calloc(new_capacity, sizeof(node_t *));
+
+    if (NULL == pp_new_items)
+    {
+        perror("Failed to calloc memory for hashtable items\n");
+        return;
+    }
+
+    p_ht->pp_old_items  = p_ht->pp_items;
+    p_ht->old_capacity  = p_ht->capacity;
+    p_ht->old_fastmod_m = p_ht->fastmod_m;
+    p_ht->migrate_index = 0;
+    p_ht->pp_items      = pp_new_items;
+    p_ht->capacity      = new_capacity;
+    p_ht->fastmod_m     = ht_fastmod_m(new_capacity);
+    p_ht->prime_index   = class_index;
+    p_ht->resize_count++;
+    HT_METRIC_ADD(p_ht, HT_METRIC_RESIZES, 1);
+    p_ht->resize_ns += ht_now_ns() - start;
+}
+
+/**
+ * @brief A private function that shrinks a table left sparse by deletes. An
+ * incremental table shrinks the way it grows, migrating a few buckets per
+ * operation, and waits for any migration in flight to drain first rather
+ * than forcing it to finish inside this delete.
+ *
+ * @param p_ht Pointer to the hashtable.
+ */
+static void ht_shrink_auto (ht_t * p_ht)
+{
+    uint32_t class_index
+        = ht_class_for_count(p_ht, p_ht->min_index, p_ht->size * 2);
+
+    if (p_ht->prime_index <= class_index)
+    {
+        return;
+    }
+
+    if (HT_RESIZE_INCREMENTAL != p_ht->resize_mode)
+    {
+        ht_resize_full(p_ht, class_index);
+    }
+    else if (NULL == p_ht->pp_old_items)
+    {
+        ht_resize_incremental(p_ht, class_index);
+    }
+}
+
+/**
+ * @brief A private function that moves every node of one old bucket into the
+ * active bucket array.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param old_index Index of the bucket in the old bucket array.
+ */
+static void ht_migrate_bucket (ht_t * p_ht, size_t old_index)
+{
+    node_t * p_chain = p_ht->pp_old_items[old_index];
+
+    if (NULL == p_chain)
+    {
+        return;
+    }
+
+    p_ht->pp_old_items[old_index] = NULL;
+    p_ht->used_buckets--;
+    ht_relink_chain(p_ht, p_chain);
+}
+
+/**
+ * @brief A private function that relinks every node of a detached chain into
+ * the active bucket array.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_chain First node of the chain.
+ */
+static void ht_relink_chain (ht_t * p_ht, node_t * p_chain)
+{
+    node_t * p_node     = p_chain;
+    node_t * p_reversed = NULL;
+
+    // Reverse the chain first so that prepending the nodes into their new
+    // buckets keeps duplicate keys in insertion order.
+    while (NULL != p_node)
+    {
+        node_t * p_next = p_node->p_next;
+        p_node->p_next  = p_reversed;
+        p_reversed      = p_node;
+        p_node          = p_next;
+    }
+
+    while (NULL != p_reversed)
+    {
+        node_t * p_next = p_reversed->p_next;
+        uint32_t index  = ht_bucket_index(
+            p_ht, p_reversed->hash, p_ht->capacity, p_ht->fastmod_m);
+
+        if (NULL == p_ht->pp_items[index])
+        {
+            p_ht->used_buckets++;
+        }
+
+        p_reversed->p_next    = p_ht->pp_items[index];
+        p_ht->pp_items[index] = p_reversed;
+        p_reversed            = p_next;
+    }
+}
+
+/**
+ * @brief A private function that moves the old bucket a hash maps to, so the
+ * caller only has to look at the active bucket array.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param hash Hash of the key about to be accessed.
+ */
+static void ht_migrate_key (ht_t * p_ht, uint32_t hash)
+{
+    if (NULL != p_ht->pp_old_items)
+    {
+        ht_migrate_bucket(p_ht,
+                          ht_bucket_index(p_ht,
+                                          hash,
+                                          p_ht->old_capacity,
+                                          p_ht->old_fastmod_m));
+    }
+}
+
+/**
+ * @brief A private function that moves up to HT_MIGRATE_STEP old buckets and
+ * releases the old bucket array once it is empty.
+ *
+ * @param p_ht Pointer to the hashtable.
+ */
+static void ht_migrate_step (ht_t * p_ht)
+{
+    if (NULL == p_ht->pp_old_items)
+    {
+        return;
+    }
+
+    // the clock reads are small next to relinking HT_MIGRATE_STEP buckets
+    uint64_t start = ht_now_ns();
+
+    for (uint32_t step = 0;
+         (step < HT_MIGRATE_STEP) && (p_ht->migrate_index < p_ht->old_capacity);
+         step++)
+    {
+        ht_migrate_bucket(p_ht, p_ht->migrate_index++);
+    }
+
+    if (p_ht->migrate_index == p_ht->old_capacity)
+    {
+        free(p_ht->pp_old_items);
+        p_ht->pp_old_items  = NULL;
+        p_ht->old_capacity  = 0;
+        p_ht->migrate_index = 0;
+    }
+
+    p_ht->resize_ns += ht_now_ns() - start;
+}
+
+/**
+ * @brief A private function that completes an in-flight migration.
+ *
+ * @param p_ht Pointer to the hashtable.
+ */
+static void ht_migrate_finish (ht_t * p_ht)
+{
+    while (NULL != p_ht->pp_old_items)
+    {
+        ht_migrate_step(p_ht);
+    }
+}
+
+/**
+ * @brief A private function that copies every node, and every owned key kept
+ * outside its node, into a fresh pool and arena and then releases the old
+ * ones. Chains keep their order. Nothing is changed unless every copy could
+ * be allocated.
+ *
+ * @param p_ht Pointer to the hashtable, with no migration in flight.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t ht_compact_nodes (ht_t * p_ht)
+{
+    error_t   retval       = E_GENERAL;
+    pool_t    new_pool     = { 0 };
+    arena_t   new_arena    = { 0 };
+    node_t ** pp_new_items = calloc(p_ht->capacity, sizeof(node_t *));
+
+    if (NULL == pp_new_items)
+    {
+        perror("Failed to calloc memory for hashtable items\n");
+        goto EXIT;
+    }
+
+    pool_init(&new_pool, p_ht->node_pool.obj_size);
+    arena_init(&new_arena);
+
+    for (size_t bucket_idx = 0; bucket_idx < p_ht->capacity; bucket_idx++)
+    {
+        node_t ** pp_tail = &pp_new_items[bucket_idx];
+
+        for (node_t * p_node = p_ht->pp_items[bucket_idx]; NULL != p_node;
+             p_node          = p_node->p_next)
+        {
+            node_t * p_copy = pool_alloc(&new_pool);
+
+            if (NULL == p_copy)
+            {
+                goto FAIL;
+            }
+
+            memcpy(p_copy, p_node, new_pool.obj_size);
+            p_copy->p_next = NULL;
+            *pp_tail       = p_copy;
+            pp_tail        = &p_copy->p_next;
+
+            if (HT_KEYS_BORROWED == p_ht->key_mode)
+            {
+                continue;
+            }
+
+            if (p_node->key_inline == p_node->p_key)
+            {
+                p_copy->p_key = p_copy->key_inline;
+            }
+            else
+            {
+                p_copy->p_key = arena_alloc(&new_arena, p_node->key_len + 1);
+
+                if (NULL == p_copy->p_key)
+                {
+                    goto FAIL;
+                }
+
+                memcpy(p_copy->p_key, p_node->p_key, p_node->key_len + 1);
+            }
+        }
+    }
+
+    pool_destroy(&p_ht->node_pool);
+    arena_destroy(&p_ht->key_arena);
+    free(p_ht->pp_items);
+    p_ht->node_pool = new_pool;
+    p_ht->key_arena = new_arena;
+    p_ht->pp_items  = pp_new_items;
+    retval          = E_SUCCESS;
+    goto EXIT;
+
+FAIL:
+    perror("Failed to allocate memory for compacted nodes\n");
+    pool_destroy(&new_pool);
+    arena_destroy(&new_arena);
+    free(pp_new_items);
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function to create a new node from the table's node pool
+ *
+ * @param p_ht Pointer to the hashtable that will own the node.
+ * @param p_key Pointer to the p_key of the new node.
+ * @param key_len Length of the key in bytes.
+ * @param p_value Pointer to the value of the new node.
+ * @param hash Hash of p_key, cached so it is never recomputed.
+ * @return node_t* On success, returns a pointer to the newly created node, else
+ * NULL;
+ */
+node_t * node_create (ht_t *       p_ht,
+                      const void * p_key,
+                      size_t       key_len,
+                      void *       p_value,
+                      uint32_t     hash)
+{
+    node_t * new_node = pool_alloc(&p_ht->node_pool);
+
+    if (new_node)
+    {
+        new_node->p_key   = (char *)p_key;
+        new_node->p_value = p_value;
+        new_node->p_next  = NULL;
+        new_node->hash    = hash;
+        new_node->key_len = (uint32_t)key_len;
+    }
+
+    if (new_node && (HT_KEYS_OWNED == p_ht->key_mode))
+    {
+        // owned keys are always terminated so they can be read as strings
+        size_t key_size = key_len + 1;
+
+        if (HT_INLINE_KEY_MAX >= key_size)
+        {
+            new_node->p_key = new_node->key_inline;
+        }
+        else
+        {
+            new_node->p_key = arena_alloc(&p_ht->key_arena, key_size);
+        }
+
+        if (NULL == new_node->p_key)
+        {
+            pool_free(&p_ht->node_pool, new_node);
+            return (NULL);
+        }
+
+        memcpy(new_node->p_key, p_key, key_len);
+        new_node->p_key[key_len] = '\0';
+    }
+
+    return (new_node);
+};
+
+/**
+ * @brief A private function to return a node, and its owned key, to the
+ * table.
+ *
+ * @param p_ht Pointer to the hashtable that owns the node.
+ * @param p_node Pointer to the node.
+ */
+static void node_free (ht_t * p_ht, node_t * p_node)
+{
+    if ((HT_KEYS_OWNED == p_ht->key_mode)
+        && (p_node->key_inline != p_node->p_key))
+    {
+        arena_free(&p_ht->key_arena, p_node->p_key, p_node->key_len + 1);
+    }
+
+    pool_free(&p_ht->node_pool, p_node);
+}
+
+/**
+ * @brief A private function that checks whether a node holds a key. Cached
+ * hashes and lengths are compared first, so key bytes are only read for a
+ * likely match.
+ *
+ * @param p_node Pointer to the node.
+ * @param p_key Pointer to the key bytes.
+ * @param key_len Length of the key in bytes.
+ * @param hash Hash of the key.
+ * @return int Non zero if the node holds the key.
+ */
+static int node_matches (node_t *     p_node,
+                         const void * p_key,
+                         size_t       key_len,
+                         uint32_t     hash)
+{
+    return ((hash == p_node->hash) && (key_len == p_node->key_len)
+            && (0 == memcmp(p_key, p_node->p_key, key_len)));
+}
+
+/**
+ * @brief Returns a monotonic timestamp. The resize timings are taken with it,
+ * and the benchmark and workload driver use it too, so every figure they
+ * report comes from the same clock.
+ *
+ * @return uint64_t Nanoseconds since an arbitrary point.
+ */
+uint64_t ht_now_ns (void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec);
+}
+
+#ifdef HT_ENABLE_METRICS
+/**
+ * @brief A private function that returns the calling thread's counter shard.
+ * Threads are dealt shards round robin on first use, so up to
+ * HT_METRICS_SHARDS threads never write the same cache line.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @return ht_metrics_shard_t* The shard.
+ */
+static ht_metrics_shard_t * ht_metrics_shard (ht_t * p_ht)
+{
+    static _Atomic uint32_t next_shard = 0;
+    static _Thread_local uint32_t tl_shard = UINT32_MAX;
+
+    if (UINT32_MAX == tl_shard)
+    {
+        tl_shard = atomic_fetch_add_explicit(
+                       &next_shard, 1, memory_order_relaxed)
+                   % HT_METRICS_SHARDS;
+    }
+
+    return (&p_ht->p_metrics[tl_shard]);
+}
+
+/**
+ * @brief A private function that adds to one of the operation counters.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param metric The counter.
+ * @param count Amount to add.
+ */
+static void ht_metric_add (ht_t * p_ht, ht_metric_t metric, uint64_t count)
+{
+    atomic_fetch_add_explicit(&ht_metrics_shard(p_ht)->counters[metric],
+                              count,
+                              memory_order_relaxed);
+}
+
+/**
+ * @brief A private function that decides whether the calling thread times
+ * the operation it is starting, 1 in every metrics_sample_every.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @return uint64_t The start timestamp, or 0 if the operation is not sampled.
+ */
+static uint64_t ht_sample_begin (ht_t * p_ht)
+{
+    static _Thread_local uint32_t tl_tick = 0;
+
+    if ((0 == p_ht->metrics_sample_every)
+        || (0 != (++tl_tick % p_ht->metrics_sample_every)))
+    {
+        return (0);
+    }
+
+    return (ht_now_ns());
+}
+
+/**
+ * @brief A private function that records the latency of a sampled operation.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param op The operation.
+ * @param start Timestamp returned by ht_sample_begin().
+ */
+static void ht_sample_end (ht_t * p_ht, ht_sample_op_t op, uint64_t start)
+{
+    if (0 == start)
+    {
+        return;
+    }
+
+    ht_metrics_shard_t * p_shard = ht_metrics_shard(p_ht);
+    uint64_t             elapsed = ht_now_ns() - start;
+    uint64_t             max_ns  = atomic_load_explicit(
+        &p_shard->sample_max_ns[op], memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&p_shard->samples[op], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(
+        &p_shard->sample_ns[op], elapsed, memory_order_relaxed);
+
+    _Atomic uint64_t * p_max = &p_shard->sample_max_ns[op];
+
+    while ((elapsed > max_ns)
+           && !atomic_compare_exchange_weak_explicit(p_max,
+                                                     &max_ns,
+                                                     elapsed,
+                                                     memory_order_relaxed,
+                                                     memory_order_relaxed))
+    {
+    }
+}
+#endif
+
+/**
+ * @brief Hashes a key of known length with the table's hash function. 64 bit
+ * results are folded to the 32 bits cached in every node.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_key Pointer to the key bytes to be hashed.
+ * @param key_len Length of the key in bytes.
+ * @return uint32_t Returns the hash value of the p_key.
+ */
+uint32_t hash_key (ht_t * p_ht, const void * p_key, size_t key_len)
+{
+    uint64_t hash = p_ht->hash_fn(p_key, key_len, p_ht->hash_seed);
+    return ((uint32_t)(hash ^ (hash >> 32)));
+}
 
 /*** end of file ***/
\ No newline at end of file
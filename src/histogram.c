@@ -0,0 +1,164 @@
+/**
+ * @file histogram.c
+ * @author Daniel Chung
+ * @brief A high dynamic range histogram in the style of HdrHistogram: exact
+ * counts for small values and a fixed number of linear sub buckets per power
+ * of two above them.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <string.h>
+#include "../include/histogram.h"
+
+static size_t   hist_index (uint64_t value);
+static uint64_t hist_highest_value (size_t index);
+
+/**
+ * @brief Empties a histogram.
+ *
+ * @param p_hist Pointer to the histogram.
+ */
+void hist_init (hist_t * p_hist)
+{
+    memset(p_hist, 0, sizeof(hist_t));
+    p_hist->min = UINT64_MAX;
+}
+
+/**
+ * @brief Records one value.
+ *
+ * @param p_hist Pointer to the histogram.
+ * @param value The value.
+ */
+void hist_record (hist_t * p_hist, uint64_t value)
+{
+    p_hist->counts[hist_index(value)]++;
+    p_hist->count++;
+    p_hist->sum += value;
+
+    if (value < p_hist->min)
+    {
+        p_hist->min = value;
+    }
+
+    if (value > p_hist->max)
+    {
+        p_hist->max = value;
+    }
+}
+
+/**
+ * @brief Adds every value recorded in one histogram to another, e.g. to
+ * combine per thread histograms.
+ *
+ * @param p_dst Pointer to the histogram added to.
+ * @param p_src Pointer to the histogram added.
+ */
+void hist_merge (hist_t * p_dst, const hist_t * p_src)
+{
+    for (size_t bucket_idx = 0; bucket_idx < HIST_BUCKET_COUNT; bucket_idx++)
+    {
+        p_dst->counts[bucket_idx] += p_src->counts[bucket_idx];
+    }
+
+    p_dst->count += p_src->count;
+    p_dst->sum += p_src->sum;
+
+    if (p_src->min < p_dst->min)
+    {
+        p_dst->min = p_src->min;
+    }
+
+    if (p_src->max > p_dst->max)
+    {
+        p_dst->max = p_src->max;
+    }
+}
+
+/**
+ * @brief Returns the value at a percentile: the highest value that falls in
+ * the same bucket as the recorded value percentile percent of all values are
+ * at or below, capped at the exact maximum.
+ *
+ * @param p_hist Pointer to the histogram.
+ * @param percentile The percentile, in [0, 100].
+ * @return uint64_t The value, or 0 if nothing was recorded.
+ */
+uint64_t hist_percentile (const hist_t * p_hist, double percentile)
+{
+    uint64_t seen = 0;
+
+    if (0 == p_hist->count)
+    {
+        return (0);
+    }
+
+    // rank of the value, counting from 1
+    uint64_t rank
+        = (uint64_t)((percentile / 100) * (double)p_hist->count + 0.5);
+
+    if (1 > rank)
+    {
+        rank = 1;
+    }
+
+    for (size_t bucket_idx = 0; bucket_idx < HIST_BUCKET_COUNT; bucket_idx++)
+    {
+        seen += p_hist->counts[bucket_idx];
+
+        if (seen >= rank)
+        {
+            uint64_t value = hist_highest_value(bucket_idx);
+
+            return ((value < p_hist->max) ? value : p_hist->max);
+        }
+    }
+
+    return (p_hist->max);
+}
+
+/**
+ * @brief A private function that maps a value to its bucket. A value below
+ * HIST_SUB_COUNT is its own bucket. Above that the value is shifted right
+ * until it has HIST_SUB_BITS significant bits, and the shift count picks the
+ * group of HIST_HALF_COUNT buckets the value lands in.
+ *
+ * @param value The value.
+ * @return size_t Index of the bucket.
+ */
+static size_t hist_index (uint64_t value)
+{
+    if (HIST_SUB_COUNT > value)
+    {
+        return ((size_t)value);
+    }
+
+    uint32_t shift = (63 - __builtin_clzll(value)) - (HIST_SUB_BITS - 1);
+
+    return ((size_t)shift * HIST_HALF_COUNT + (size_t)(value >> shift));
+}
+
+/**
+ * @brief A private function that returns the highest value a bucket holds.
+ *
+ * @param index Index of the bucket.
+ * @return uint64_t The value.
+ */
+static uint64_t hist_highest_value (size_t index)
+{
+    if (HIST_SUB_COUNT > index)
+    {
+        return ((uint64_t)index);
+    }
+
+    uint32_t shift = (uint32_t)(index / HIST_HALF_COUNT) - 1;
+    uint64_t sub   = index - (size_t)shift * HIST_HALF_COUNT;
+
+    return (((sub + 1) << shift) - 1);
+}
+
+/*** end of file ***/
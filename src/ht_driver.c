@@ -1,19 +1,641 @@
+/**
+ * @file ht_driver.c
+ * @author Daniel Chung
+ * @brief A YCSB style workload driver. It loads a number of records, then runs
+ * a mix of reads, updates, inserts and deletes over a uniform, zipfian or
+ * latest key distribution and reports the throughput along with latency
+ * percentiles of every operation type. A single thread drives
+ * the hashtable module, more than one share the concurrent hashtable.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include "../include/hashtable.h"
+#include "../include/concurrent_hashtable.h"
+#include "../include/epoch.h"
+#include "../include/workload.h"
+#include "../include/histogram.h"
 #include "../include/errorcode.h"
 
-int main (void)
+typedef enum drv_op_t
+{
+    DRV_READ = 0,
+    DRV_UPDATE,
+    DRV_INSERT,
+    DRV_DELETE,
+    DRV_OP_COUNT,
+} drv_op_t;
+
+typedef struct drv_config_t
+{
+    size_t    records;  // loaded before the run
+    size_t    ops;      // per thread
+    size_t    threads;
+    size_t    key_len;
+    uint32_t  mix[DRV_OP_COUNT]; // percentages, summing to 100
+    wl_dist_t dist;
+    double    theta;
+} drv_config_t;
+
+typedef struct drv_shared_t
 {
-    ht_t * p_ht = ht_create(0);
+    drv_config_t     config;
+    wl_keygen_t      keygen;
+    char *           p_keys;       // key_capacity keys of key_len + 1 bytes
+    size_t           key_capacity;
+    _Atomic uint64_t next_id;      // id of the next key to be inserted
+    ht_t *           p_ht;         // used by a single thread
+    cht_t *          p_cht;        // used by several threads
+    pthread_mutex_t  start_lock;   // start gate, portable unlike barriers
+    pthread_cond_t   start_cond;
+    int              start_open;   // guarded by start_lock
+} drv_shared_t;
+
+typedef struct drv_thread_t
+{
+    pthread_t      thread;
+    drv_shared_t * p_shared;
+    uint64_t       rng;
+    hist_t         latencies[DRV_OP_COUNT]; // nanoseconds per operation
+    uint64_t       read_misses;
+} drv_thread_t;
+
+static const char * gp_op_names[DRV_OP_COUNT]
+    = { "read", "update", "insert", "delete" };
+
+static error_t  drv_parse_args (drv_config_t * p_config,
+                                int            argc,
+                                char **        argv);
+static error_t  drv_parse_mix (drv_config_t * p_config, char * p_arg);
+static void     drv_usage (const char * p_name);
+static char *   drv_key (drv_shared_t * p_shared, uint64_t id);
+static error_t  drv_load (drv_shared_t * p_shared);
+static void *   drv_run_thread (void * p_arg);
+static char *   drv_pick_key (drv_thread_t * p_thread, drv_op_t op);
+static void     drv_run_op (drv_thread_t * p_thread, drv_op_t op, char * p_key);
+static void     drv_print_latency (const char * p_name, const hist_t * p_hist);
+
+int main (int argc, char ** argv)
+{
+    int            retval    = EXIT_FAILURE;
+    drv_shared_t   shared    = { 0 };
+    drv_thread_t * p_threads = NULL;
+    drv_config_t * p_config  = &shared.config;
+    size_t         started   = 0;
+
+    if (E_SUCCESS != drv_parse_args(p_config, argc, argv))
+    {
+        drv_usage(argv[0]);
+        goto EXIT;
+    }
+
+    // every operation of every thread could be an insert of a new key
+    shared.key_capacity = p_config->records;
+
+    if (0 != p_config->mix[DRV_INSERT])
+    {
+        shared.key_capacity += p_config->threads * p_config->ops;
+    }
+
+    shared.p_keys = malloc(shared.key_capacity * (p_config->key_len + 1));
+    p_threads     = calloc(p_config->threads, sizeof(drv_thread_t));
 
-    if (NULL == p_ht)
+    if (NULL == shared.p_keys || NULL == p_threads)
+    {
+        perror("Failed to allocate memory for the workload\n");
+        goto EXIT;
+    }
+
+    if (E_SUCCESS
+        != wl_keygen_init(&shared.keygen,
+                          p_config->dist,
+                          (0 != p_config->records) ? p_config->records : 1,
+                          p_config->theta))
+    {
+        fprintf(stderr, "Invalid key distribution parameters\n");
+        goto EXIT;
+    }
+
+    if (1 == p_config->threads)
+    {
+        shared.p_ht = ht_create_reserve(p_config->records);
+    }
+    else
+    {
+        shared.p_cht = cht_create(0);
+    }
+
+    if (NULL == shared.p_ht && NULL == shared.p_cht)
     {
         printf("Failed to create hashtable\n");
-        return (EXIT_FAILURE);
+        goto EXIT;
+    }
+
+    if (E_SUCCESS != drv_load(&shared))
+    {
+        goto EXIT;
+    }
+
+    pthread_mutex_init(&shared.start_lock, NULL);
+    pthread_cond_init(&shared.start_cond, NULL);
+
+    for (started = 0; started < p_config->threads; started++)
+    {
+        p_threads[started].p_shared = &shared;
+        p_threads[started].rng      = 0x5DEECE66D + started;
+
+        if (0 != pthread_create(&p_threads[started].thread,
+                                NULL,
+                                drv_run_thread,
+                                &p_threads[started]))
+        {
+            // threads already waiting at the start gate are never released
+            perror("Failed to create workload thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // every thread exists, so opening the gate starts them all at once
+    uint64_t start = ht_now_ns();
+
+    pthread_mutex_lock(&shared.start_lock);
+    shared.start_open = 1;
+    pthread_cond_broadcast(&shared.start_cond);
+    pthread_mutex_unlock(&shared.start_lock);
+
+    for (size_t thread_idx = 0; thread_idx < started; thread_idx++)
+    {
+        pthread_join(p_threads[thread_idx].thread, NULL);
+    }
+
+    double   seconds = (double)(ht_now_ns() - start) / 1e9;
+    uint64_t total   = p_config->threads * p_config->ops;
+
+    pthread_cond_destroy(&shared.start_cond);
+    pthread_mutex_destroy(&shared.start_lock);
+    printf("run: %zu ops on %zu thread(s) in %.3f s, %.0f ops/sec\n",
+           (size_t)total, p_config->threads, seconds,
+           (0 < seconds) ? (double)total / seconds : 0);
+
+    hist_t * p_total = malloc(sizeof(hist_t));
+
+    if (NULL == p_total)
+    {
+        perror("Failed to malloc memory for latency histogram\n");
+        goto EXIT;
+    }
+
+    for (int op = 0; op < DRV_OP_COUNT; op++)
+    {
+        hist_init(p_total);
+
+        for (size_t thread_idx = 0; thread_idx < started; thread_idx++)
+        {
+            hist_merge(p_total, &p_threads[thread_idx].latencies[op]);
+        }
+
+        drv_print_latency(gp_op_names[op], p_total);
+    }
+
+    uint64_t misses = 0;
+
+    for (size_t thread_idx = 0; thread_idx < started; thread_idx++)
+    {
+        misses += p_threads[thread_idx].read_misses;
+    }
+
+    printf("  %llu reads missed\n", (unsigned long long)misses);
+    free(p_total);
+
+    retval = EXIT_SUCCESS;
+
+EXIT:
+    ht_destroy(shared.p_ht);
+
+    if (NULL != shared.p_cht)
+    {
+        cht_destroy(shared.p_cht);
+        epoch_drain();
+    }
+
+    free(shared.p_keys);
+    free(p_threads);
+
+    return (retval);
+}
+
+/**
+ * @brief A private function that fills in the configuration from the command
+ * line. Defaults run YCSB workload A, 50% reads and 50% updates over a
+ * zipfian distribution, on a single thread.
+ *
+ * @param p_config Pointer to the configuration.
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t drv_parse_args (drv_config_t * p_config, int argc, char ** argv)
+{
+    error_t retval   = E_GENERAL;
+    int     opt      = 0;
+    int     dist_set = 0;
+
+    p_config->records         = 100000;
+    p_config->ops             = 1000000;
+    p_config->threads         = 1;
+    p_config->key_len         = 16;
+    p_config->mix[DRV_READ]   = 50;
+    p_config->mix[DRV_UPDATE] = 50;
+    p_config->dist            = WL_DIST_ZIPFIAN;
+    p_config->theta           = WL_ZIPF_THETA;
+
+    while (-1 != (opt = getopt(argc, argv, "r:o:t:k:w:m:d:z:h")))
+    {
+        switch (opt)
+        {
+            case 'r':
+                p_config->records = strtoull(optarg, NULL, 10);
+                break;
+            case 'o':
+                p_config->ops = strtoull(optarg, NULL, 10);
+                break;
+            case 't':
+                p_config->threads = strtoull(optarg, NULL, 10);
+                break;
+            case 'k':
+                p_config->key_len = strtoull(optarg, NULL, 10);
+                break;
+            case 'w':
+                if (0 == strcmp(optarg, "a"))
+                {
+                    retval = drv_parse_mix(p_config, (char[]) { "50,50,0,0" });
+                }
+                else if (0 == strcmp(optarg, "b"))
+                {
+                    retval = drv_parse_mix(p_config, (char[]) { "95,5,0,0" });
+                }
+                else if (0 == strcmp(optarg, "c"))
+                {
+                    retval = drv_parse_mix(p_config, (char[]) { "100,0,0,0" });
+                }
+                else if (0 == strcmp(optarg, "d"))
+                {
+                    retval = drv_parse_mix(p_config, (char[]) { "95,0,5,0" });
+                    p_config->dist = dist_set ? p_config->dist
+                                              : WL_DIST_LATEST;
+                }
+                else
+                {
+                    goto EXIT;
+                }
+
+                if (E_SUCCESS != retval)
+                {
+                    goto EXIT;
+                }
+
+                break;
+            case 'm':
+                if (E_SUCCESS != drv_parse_mix(p_config, optarg))
+                {
+                    goto EXIT;
+                }
+
+                break;
+            case 'd':
+                dist_set = 1;
+
+                if (0 == strcmp(optarg, "uniform"))
+                {
+                    p_config->dist = WL_DIST_UNIFORM;
+                }
+                else if (0 == strcmp(optarg, "zipfian"))
+                {
+                    p_config->dist = WL_DIST_ZIPFIAN;
+                }
+                else if (0 == strcmp(optarg, "latest"))
+                {
+                    p_config->dist = WL_DIST_LATEST;
+                }
+                else
+                {
+                    goto EXIT;
+                }
+
+                break;
+            case 'z':
+                p_config->theta = strtod(optarg, NULL);
+                break;
+            default:
+                goto EXIT;
+        }
+    }
+
+    if ((0 == p_config->threads) || (WL_KEY_LEN_MIN > p_config->key_len)
+        || (HT_KEY_LEN_MAX < p_config->key_len) || (0 == p_config->ops))
+    {
+        goto EXIT;
+    }
+
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that parses an operation mix of four comma
+ * separated percentages: read, update, insert and delete.
+ *
+ * @param p_config Pointer to the configuration.
+ * @param p_arg The mix.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t drv_parse_mix (drv_config_t * p_config, char * p_arg)
+{
+    error_t  retval = E_GENERAL;
+    uint32_t total  = 0;
+    int      op     = 0;
+
+    for (char * p_token = strtok(p_arg, ","); NULL != p_token;
+         p_token        = strtok(NULL, ","))
+    {
+        if (DRV_OP_COUNT <= op)
+        {
+            goto EXIT;
+        }
+
+        p_config->mix[op] = (uint32_t)strtoul(p_token, NULL, 10);
+        total += p_config->mix[op++];
+    }
+
+    if ((DRV_OP_COUNT != op) || (100 != total))
+    {
+        goto EXIT;
+    }
+
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that prints the command line options.
+ *
+ * @param p_name Name of the program.
+ */
+static void drv_usage (const char * p_name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -r records   records loaded before the run (100000)\n"
+            "  -o ops       operations per thread (1000000)\n"
+            "  -t threads   worker threads, more than one use the concurrent "
+            "table (1)\n"
+            "  -k bytes     key length, at least %d (16)\n"
+            "  -w a|b|c|d   YCSB core workload mix (a)\n"
+            "  -m r,u,i,d   read, update, insert and delete percentages\n"
+            "  -d dist      uniform, zipfian or latest (zipfian, latest for "
+            "d)\n"
+            "  -z theta     zipfian skew in (0, 1) (%.2f)\n",
+            p_name,
+            WL_KEY_LEN_MIN,
+            WL_ZIPF_THETA);
+}
+
+/**
+ * @brief A private function that returns the key of an id.
+ *
+ * @param p_shared Pointer to the shared workload state.
+ * @param id The key id, below key_capacity.
+ * @return char* The key.
+ */
+static char * drv_key (drv_shared_t * p_shared, uint64_t id)
+{
+    return (p_shared->p_keys + id * (p_shared->config.key_len + 1));
+}
+
+/**
+ * @brief A private function that generates every key and inserts the initial
+ * records.
+ *
+ * @param p_shared Pointer to the shared workload state.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t drv_load (drv_shared_t * p_shared)
+{
+    error_t  retval  = E_GENERAL;
+    size_t   key_len = p_shared->config.key_len;
+    hist_t * p_hist  = malloc(sizeof(hist_t));
+
+    if (NULL == p_hist)
+    {
+        perror("Failed to malloc memory for latency histogram\n");
+        goto EXIT;
+    }
+
+    hist_init(p_hist);
+
+    for (size_t id = 0; id < p_shared->key_capacity; id++)
+    {
+        wl_make_key(drv_key(p_shared, id), key_len, id);
+    }
+
+    uint64_t start = ht_now_ns();
+    uint64_t prev  = start;
+
+    for (size_t id = 0; id < p_shared->config.records; id++)
+    {
+        char * p_key = drv_key(p_shared, id);
+
+        retval = (NULL != p_shared->p_ht)
+                     ? ht_insert(&p_shared->p_ht, p_key, p_key)
+                     : cht_insert(p_shared->p_cht, p_key, p_key);
+
+        uint64_t now = ht_now_ns();
+        hist_record(p_hist, now - prev);
+        prev = now;
+
+        if (E_SUCCESS != retval)
+        {
+            fprintf(stderr, "Failed to load record %zu\n", id);
+            goto EXIT;
+        }
     }
 
-    ht_destroy(p_ht);
+    double seconds = (double)(prev - start) / 1e9;
+
+    atomic_store(&p_shared->next_id, p_shared->config.records);
+    // an empty or sub-tick load has no meaningful rate
+    printf("load: %zu records in %.3f s, %.0f ops/sec\n",
+           p_shared->config.records, seconds,
+           (0 < seconds) ? (double)p_shared->config.records / seconds : 0);
+    drv_print_latency("insert", p_hist);
+    retval = E_SUCCESS;
+
+EXIT:
+    free(p_hist);
+    return (retval);
+}
+
+/**
+ * @brief A private function that runs one thread's share of the workload.
+ *
+ * @param p_arg Pointer to the thread's drv_thread_t.
+ * @return void* Always NULL.
+ */
+static void * drv_run_thread (void * p_arg)
+{
+    drv_thread_t * p_thread = p_arg;
+    drv_config_t * p_config = &p_thread->p_shared->config;
+
+    for (int op = 0; op < DRV_OP_COUNT; op++)
+    {
+        hist_init(&p_thread->latencies[op]);
+    }
+
+    pthread_mutex_lock(&p_thread->p_shared->start_lock);
+
+    while (0 == p_thread->p_shared->start_open)
+    {
+        pthread_cond_wait(&p_thread->p_shared->start_cond,
+                          &p_thread->p_shared->start_lock);
+    }
+
+    pthread_mutex_unlock(&p_thread->p_shared->start_lock);
+
+    for (size_t op_idx = 0; op_idx < p_config->ops; op_idx++)
+    {
+        uint32_t dice = (uint32_t)(wl_rand(&p_thread->rng) % 100);
+        drv_op_t op   = DRV_READ;
+
+        while ((DRV_OP_COUNT - 1 > op) && (dice >= p_config->mix[op]))
+        {
+            dice -= p_config->mix[op];
+            op++;
+        }
+
+        // the key draw stays outside the timed section, so only the table
+        // call itself is measured
+        char *   p_key = drv_pick_key(p_thread, op);
+        uint64_t start = ht_now_ns();
+
+        drv_run_op(p_thread, op, p_key);
+        hist_record(&p_thread->latencies[op], ht_now_ns() - start);
+    }
+
+    return (NULL);
+}
+
+/**
+ * @brief A private function that picks the key of the next operation. Inserts
+ * take a key that was never used before, everything else picks an existing
+ * key through the key distribution.
+ *
+ * @param p_thread Pointer to the calling thread's state.
+ * @param op The operation.
+ * @return char* The key.
+ */
+static char * drv_pick_key (drv_thread_t * p_thread, drv_op_t op)
+{
+    drv_shared_t * p_shared = p_thread->p_shared;
+    uint64_t       id       = 0;
+
+    if (DRV_INSERT == op)
+    {
+        id = atomic_fetch_add(&p_shared->next_id, 1);
+    }
+    else
+    {
+        id = wl_keygen_next(&p_shared->keygen,
+                            &p_thread->rng,
+                            atomic_load_explicit(&p_shared->next_id,
+                                                 memory_order_relaxed));
+    }
+
+    return (drv_key(p_shared, id));
+}
+
+/**
+ * @brief A private function that performs one operation on a key. Keys
+ * another thread is still inserting, or that were deleted, count as read
+ * misses.
+ *
+ * @param p_thread Pointer to the calling thread's state.
+ * @param op The operation.
+ * @param p_key The key, from drv_pick_key().
+ */
+static void drv_run_op (drv_thread_t * p_thread, drv_op_t op, char * p_key)
+{
+    drv_shared_t * p_shared = p_thread->p_shared;
+
+    switch (op)
+    {
+        case DRV_READ:
+            if (NULL
+                == ((NULL != p_shared->p_ht)
+                        ? ht_search(p_shared->p_ht, p_key)
+                        : cht_search(p_shared->p_cht, p_key)))
+            {
+                p_thread->read_misses++;
+            }
+
+            break;
+        case DRV_UPDATE:
+        case DRV_INSERT:
+            if (NULL != p_shared->p_ht)
+            {
+                ht_upsert(&p_shared->p_ht, p_key, p_key);
+            }
+            else
+            {
+                cht_insert(p_shared->p_cht, p_key, p_key);
+            }
+
+            break;
+        case DRV_DELETE:
+        default:
+            if (NULL != p_shared->p_ht)
+            {
+                ht_delete(p_shared->p_ht, p_key);
+            }
+            else
+            {
+                cht_delete(p_shared->p_cht, p_key);
+            }
+
+            break;
+    }
+}
+
+/**
+ * @brief A private function that prints the operation count and latency
+ * percentiles of one operation type.
+ *
+ * @param p_name Name of the operation.
+ * @param p_hist Pointer to its latency histogram.
+ */
+static void drv_print_latency (const char * p_name, const hist_t * p_hist)
+{
+    printf("  %-6s %12llu ops  p50 %8llu ns  p99 %8llu ns  p99.9 %8llu ns"
+           "  max %10llu ns\n",
+           p_name,
+           (unsigned long long)p_hist->count,
+           (unsigned long long)hist_percentile(p_hist, 50),
+           (unsigned long long)hist_percentile(p_hist, 99),
+           (unsigned long long)hist_percentile(p_hist, 99.9),
+           (unsigned long long)p_hist->max);
+}
 
-    return (EXIT_SUCCESS);
-}
\ No newline at end of file
+/*** end of file ***/
@@ -0,0 +1,343 @@
+/**
+ * @file oa_hashtable.c
+ * @author Daniel Chung
+ * @brief A hashtable implementation using open addressing with Robin Hood
+ * linear probing, backward shift deletion and murmurhash3.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/oa_hashtable.h"
+#include "../include/hashtable.h"
+#include "../include/hash.h"
+#include "../include/errorcode.h"
+
+static uint32_t oa_hash_str (char * p_key);
+static void     oa_place (oa_ht_t * p_ht, oa_slot_t entry);
+static ssize_t  oa_find (oa_ht_t * p_ht, char * p_key, uint32_t hash);
+static error_t  oa_grow (oa_ht_t * p_ht);
+
+/**
+ * @brief Creates a new open addressing hashtable on heap.
+ *
+ * @param prime_index The index of the prime number to use for the hashtable
+ * @return oa_ht_t* On success, returns a pointer to the newly created
+ * hashtable, else NULL.
+ */
+oa_ht_t * oa_ht_create (int prime_index)
+{
+    oa_ht_t * new_ht = NULL;
+
+    if (0 > prime_index || HT_PRIME_COUNT <= prime_index)
+    {
+        goto EXIT;
+    }
+
+    new_ht = malloc(sizeof(oa_ht_t));
+
+    if (NULL == new_ht)
+    {
+        goto EXIT;
+    }
+
+    new_ht->size        = 0;
+    new_ht->prime_index = prime_index;
+    new_ht->capacity    = g_primes[new_ht->prime_index];
+    new_ht->p_slots     = calloc(new_ht->capacity, sizeof(oa_slot_t));
+
+    if (NULL == new_ht->p_slots)
+    {
+        perror("Failed to calloc memory for hashtable slots\n");
+        free(new_ht);
+        new_ht = NULL;
+        goto EXIT;
+    }
+
+EXIT:
+    return (new_ht);
+}
+
+/**
+ * @brief Destroys an open addressing hashtable.
+ *
+ * @param p_ht Pointer to the hashtable to be destroyed.
+ * @return error_t On success, returns 0, else non zero error
+ */
+error_t oa_ht_destroy (oa_ht_t * p_ht)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    free(p_ht->p_slots);
+    free(p_ht);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Inserts a key into the hashtable. Unlike ht_insert(), an existing
+ * entry for the same key has its value replaced, since an open addressed
+ * table keeps exactly one slot per key.
+ *
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Char pointer to the key of the new entry.
+ * @param p_value Void pointer to the value of the new entry.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t oa_ht_insert (oa_ht_t ** pp_ht, char * p_key, void * p_value)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == pp_ht || NULL == *pp_ht || NULL == p_key)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    oa_ht_t * p_ht  = *pp_ht;
+    uint32_t  hash  = oa_hash_str(p_key);
+    ssize_t   found = oa_find(p_ht, p_key, hash);
+
+    if (0 <= found)
+    {
+        p_ht->p_slots[found].p_value = p_value;
+        retval                       = E_SUCCESS;
+        goto EXIT;
+    }
+
+    // typecast to double to avoid integer division
+    if ((double)(p_ht->size + 1) / p_ht->capacity > OA_HT_MAX_LOAD)
+    {
+        retval = oa_grow(p_ht);
+
+        if ((E_SUCCESS != retval) && (p_ht->size + 1 >= p_ht->capacity))
+        {
+            retval = E_HASHTABLE_INSERT;
+            goto EXIT;
+        }
+    }
+
+    oa_slot_t entry = { .p_key = p_key, .p_value = p_value, .hash = hash };
+    oa_place(p_ht, entry);
+    p_ht->size++;
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Deletes a key from the hashtable. The entries following it in the
+ * probe sequence are shifted back by one slot, so no tombstones are left.
+ *
+ * @param p_ht Pointer to the hashtable
+ * @param p_key Char pointer to the key of the entry to be deleted.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t oa_ht_delete (oa_ht_t * p_ht, char * p_key)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht || NULL == p_key)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    ssize_t found = oa_find(p_ht, p_key, oa_hash_str(p_key));
+
+    if (0 > found)
+    {
+        retval = E_NODE_NOT_FOUND;
+        goto EXIT;
+    }
+
+    size_t index = (size_t)found;
+    size_t next  = (index + 1 == p_ht->capacity) ? 0 : index + 1;
+
+    while (1 < p_ht->p_slots[next].dist)
+    {
+        p_ht->p_slots[index] = p_ht->p_slots[next];
+        p_ht->p_slots[index].dist--;
+        index = next;
+        next  = (index + 1 == p_ht->capacity) ? 0 : index + 1;
+    }
+
+    memset(&p_ht->p_slots[index], 0, sizeof(oa_slot_t));
+    p_ht->size--;
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Searches the hashtable for a key.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_key Char pointer to the key to be searched for.
+ * @return void* On success, returns a pointer to the value of the key, else
+ * NULL.
+ */
+void * oa_ht_search (oa_ht_t * p_ht, char * p_key)
+{
+    void * retval = NULL;
+
+    if (NULL == p_ht || NULL == p_key)
+    {
+        goto EXIT;
+    }
+
+    ssize_t found = oa_find(p_ht, p_key, oa_hash_str(p_key));
+
+    if (0 <= found)
+    {
+        retval = p_ht->p_slots[found].p_value;
+    }
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that looks up the slot holding a key. The probe
+ * stops as soon as it meets an entry closer to its home slot than the key
+ * would be, which Robin Hood ordering guarantees it cannot be past.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_key Char pointer to the key.
+ * @param hash Hash of the key.
+ * @return ssize_t Index of the slot, or -1 if the key is not present.
+ */
+static ssize_t oa_find (oa_ht_t * p_ht, char * p_key, uint32_t hash)
+{
+    size_t   index = hash % p_ht->capacity;
+    uint32_t dist  = 1;
+
+    for (;;)
+    {
+        oa_slot_t * p_slot = &p_ht->p_slots[index];
+
+        if (p_slot->dist < dist)
+        {
+            return (-1);
+        }
+
+        if ((hash == p_slot->hash) && (0 == strcmp(p_key, p_slot->p_key)))
+        {
+            return ((ssize_t)index);
+        }
+
+        dist++;
+        index = (index + 1 == p_ht->capacity) ? 0 : index + 1;
+    }
+}
+
+/**
+ * @brief A private function that stores an entry known not to be in the
+ * table yet. Whenever the entry being carried is further from home than the
+ * resident one, the two swap places and the resident continues probing.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param entry The entry to be placed.
+ */
+static void oa_place (oa_ht_t * p_ht, oa_slot_t entry)
+{
+    size_t index = entry.hash % p_ht->capacity;
+
+    entry.dist = 1;
+
+    for (;;)
+    {
+        oa_slot_t * p_slot = &p_ht->p_slots[index];
+
+        if (0 == p_slot->dist)
+        {
+            *p_slot = entry;
+            return;
+        }
+
+        if (p_slot->dist < entry.dist)
+        {
+            oa_slot_t resident = *p_slot;
+            *p_slot            = entry;
+            entry              = resident;
+        }
+
+        entry.dist++;
+        index = (index + 1 == p_ht->capacity) ? 0 : index + 1;
+    }
+}
+
+/**
+ * @brief A private function that moves every entry into a slot array sized
+ * for the next prime. Entries carry their hash, so no key is rehashed.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t oa_grow (oa_ht_t * p_ht)
+{
+    error_t retval = E_GENERAL;
+
+    if (HT_PRIME_COUNT <= p_ht->prime_index + 1)
+    {
+        goto EXIT;
+    }
+
+    size_t      new_capacity = g_primes[p_ht->prime_index + 1];
+    oa_slot_t * p_new_slots  = calloc(new_capacity, sizeof(oa_slot_t));
+
+    if (NULL == p_new_slots)
+    {
+        perror("Failed to calloc memory for hashtable slots\n");
+        goto EXIT;
+    }
+
+    oa_slot_t * p_old_slots  = p_ht->p_slots;
+    size_t      old_capacity = p_ht->capacity;
+
+    p_ht->p_slots  = p_new_slots;
+    p_ht->capacity = new_capacity;
+    p_ht->prime_index++;
+
+    for (size_t old_idx = 0; old_idx < old_capacity; old_idx++)
+    {
+        if (0 != p_old_slots[old_idx].dist)
+        {
+            oa_place(p_ht, p_old_slots[old_idx]);
+        }
+    }
+
+    free(p_old_slots);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Hashes a string key.
+ *
+ * @param p_key Pointer to the string key to be hashed.
+ * @return uint32_t Returns the hash value of the key.
+ */
+static uint32_t oa_hash_str (char * p_key)
+{
+    return (murmurhash(p_key, strlen(p_key), 0));
+}
+
+/*** end of file ***/
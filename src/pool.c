@@ -0,0 +1,146 @@
+/**
+ * @file pool.c
+ * @author Daniel Chung
+ * @brief A fixed size object pool that allocates in large blocks.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/pool.h"
+#include "../include/errorcode.h"
+
+/**
+ * @brief Object alignment. Objects are at least pointer sized so a freed one
+ * can hold the free list link.
+ */
+#define POOL_ALIGN (_Alignof(max_align_t))
+
+/**
+ * @brief Blocks start on a cache line and the header takes a whole line, so
+ * objects whose size is a multiple of 64 bytes never straddle two lines.
+ */
+#define POOL_BLOCK_ALIGN 64
+#define POOL_HEADER_SIZE POOL_BLOCK_ALIGN
+
+/**
+ * @brief Initializes an empty pool. No memory is allocated until the first
+ * pool_alloc().
+ *
+ * @param p_pool Pointer to the pool.
+ * @param obj_size Size of every object in bytes.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t pool_init (pool_t * p_pool, size_t obj_size)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_pool)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    if (obj_size < sizeof(void *))
+    {
+        obj_size = sizeof(void *);
+    }
+
+    p_pool->p_blocks    = NULL;
+    p_pool->p_free      = NULL;
+    p_pool->p_bump      = NULL;
+    p_pool->p_bump_end  = NULL;
+    p_pool->obj_size    = (obj_size + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1);
+    p_pool->block_objs  = POOL_MIN_BLOCK_OBJS;
+    p_pool->block_bytes = 0;
+    retval              = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Allocates one object, reusing a freed one when possible.
+ *
+ * @param p_pool Pointer to the pool.
+ * @return void* On success, returns a pointer to the object, else NULL.
+ */
+void * pool_alloc (pool_t * p_pool)
+{
+    void * p_obj = p_pool->p_free;
+
+    if (NULL != p_obj)
+    {
+        p_pool->p_free = *(void **)p_obj;
+        return (p_obj);
+    }
+
+    if (p_pool->p_bump == p_pool->p_bump_end)
+    {
+        size_t used = POOL_HEADER_SIZE + p_pool->block_objs * p_pool->obj_size;
+        // aligned_alloc wants a multiple of the alignment
+        size_t size = (used + POOL_BLOCK_ALIGN - 1) & ~(POOL_BLOCK_ALIGN - 1);
+        pool_block_t * p_block = aligned_alloc(POOL_BLOCK_ALIGN, size);
+
+        if (NULL == p_block)
+        {
+            perror("Failed to allocate memory for pool block\n");
+            return (NULL);
+        }
+
+        p_block->p_next     = p_pool->p_blocks;
+        p_block->size       = size;
+        p_pool->p_blocks    = p_block;
+        p_pool->p_bump      = (char *)p_block + POOL_HEADER_SIZE;
+        p_pool->p_bump_end  = (char *)p_block + used;
+        p_pool->block_bytes += size;
+
+        if (POOL_MAX_BLOCK_OBJS > p_pool->block_objs)
+        {
+            p_pool->block_objs <<= 1;
+        }
+    }
+
+    p_obj = p_pool->p_bump;
+    p_pool->p_bump += p_pool->obj_size;
+
+    return (p_obj);
+}
+
+/**
+ * @brief Returns an object to the pool's free list.
+ *
+ * @param p_pool Pointer to the pool.
+ * @param p_obj Pointer to an object allocated from this pool.
+ */
+void pool_free (pool_t * p_pool, void * p_obj)
+{
+    *(void **)p_obj = p_pool->p_free;
+    p_pool->p_free  = p_obj;
+}
+
+/**
+ * @brief Releases every block of the pool, and with them every object.
+ *
+ * @param p_pool Pointer to the pool.
+ */
+void pool_destroy (pool_t * p_pool)
+{
+    pool_block_t * p_block = p_pool->p_blocks;
+
+    while (NULL != p_block)
+    {
+        pool_block_t * p_next = p_block->p_next;
+        free(p_block);
+        p_block = p_next;
+    }
+
+    pool_init(p_pool, p_pool->obj_size);
+}
+
+/*** end of file ***/
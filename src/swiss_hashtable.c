@@ -0,0 +1,428 @@
+/**
+ * @file swiss_hashtable.c
+ * @author Daniel Chung
+ * @brief A hashtable implementation using SwissTable style group probing over
+ * one byte control tags and murmurhash3.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/swiss_hashtable.h"
+#include "../include/hashtable.h"
+#include "../include/hash.h"
+#include "../include/errorcode.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static uint32_t sw_match (const int8_t * p_group, int8_t tag);
+static uint32_t sw_match_free (const int8_t * p_group);
+static ssize_t  sw_find (sw_ht_t * p_ht, char * p_key, uint32_t hash);
+static size_t   sw_find_free (sw_ht_t * p_ht, uint32_t hash);
+static error_t  sw_rehash (sw_ht_t * p_ht, size_t new_capacity);
+
+/**
+ * @brief Creates a new group probing hashtable on heap. The slot count is the
+ * prime at prime_index rounded up to a power of two multiple of
+ * SW_GROUP_WIDTH.
+ *
+ * @param prime_index The index of the prime number to size the hashtable by.
+ * @return sw_ht_t* On success, returns a pointer to the newly created
+ * hashtable, else NULL.
+ */
+sw_ht_t * sw_ht_create (int prime_index)
+{
+    sw_ht_t * new_ht = NULL;
+
+    if (0 > prime_index || HT_PRIME_COUNT <= prime_index)
+    {
+        goto EXIT;
+    }
+
+    new_ht = calloc(1, sizeof(sw_ht_t));
+
+    if (NULL == new_ht)
+    {
+        goto EXIT;
+    }
+
+    size_t capacity = SW_GROUP_WIDTH;
+
+    while (capacity < g_primes[prime_index])
+    {
+        capacity <<= 1;
+    }
+
+    if (E_SUCCESS != sw_rehash(new_ht, capacity))
+    {
+        free(new_ht);
+        new_ht = NULL;
+        goto EXIT;
+    }
+
+EXIT:
+    return (new_ht);
+}
+
+/**
+ * @brief Destroys a group probing hashtable.
+ *
+ * @param p_ht Pointer to the hashtable to be destroyed.
+ * @return error_t On success, returns 0, else non zero error
+ */
+error_t sw_ht_destroy (sw_ht_t * p_ht)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    free(p_ht->p_ctrl);
+    free(p_ht->p_slots);
+    free(p_ht);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Inserts a key into the hashtable, replacing the value of an existing
+ * entry for the same key.
+ *
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param p_key Char pointer to the key of the new entry.
+ * @param p_value Void pointer to the value of the new entry.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t sw_ht_insert (sw_ht_t ** pp_ht, char * p_key, void * p_value)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == pp_ht || NULL == *pp_ht || NULL == p_key)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    sw_ht_t * p_ht  = *pp_ht;
+    uint32_t  hash  = murmurhash(p_key, strlen(p_key), 0);
+    ssize_t   found = sw_find(p_ht, p_key, hash);
+
+    if (0 <= found)
+    {
+        p_ht->p_slots[found].p_value = p_value;
+        retval                       = E_SUCCESS;
+        goto EXIT;
+    }
+
+    // Keep at most 7/8 of the slots in use. If tombstones are what pushes the
+    // table over, rehashing at the same capacity is enough to clear them.
+    if ((p_ht->size + p_ht->tombstones + 1) * 8 > p_ht->capacity * 7)
+    {
+        size_t new_capacity = p_ht->capacity;
+
+        if ((p_ht->size + 1) * 16 > p_ht->capacity * 7)
+        {
+            new_capacity <<= 1;
+        }
+
+        if ((E_SUCCESS != sw_rehash(p_ht, new_capacity))
+            && (p_ht->size + p_ht->tombstones + 1 >= p_ht->capacity))
+        {
+            retval = E_HASHTABLE_INSERT;
+            goto EXIT;
+        }
+    }
+
+    size_t index = sw_find_free(p_ht, hash);
+
+    if (SW_CTRL_DELETED == p_ht->p_ctrl[index])
+    {
+        p_ht->tombstones--;
+    }
+
+    p_ht->p_ctrl[index]          = (int8_t)(hash & 0x7f);
+    p_ht->p_slots[index].p_key   = p_key;
+    p_ht->p_slots[index].p_value = p_value;
+    p_ht->p_slots[index].hash    = hash;
+    p_ht->size++;
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Deletes a key from the hashtable. The slot becomes empty again if
+ * its group still has an empty slot, since then no probe can have passed the
+ * group; otherwise it is marked deleted.
+ *
+ * @param p_ht Pointer to the hashtable
+ * @param p_key Char pointer to the key of the entry to be deleted.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t sw_ht_delete (sw_ht_t * p_ht, char * p_key)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht || NULL == p_key)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    ssize_t found
+        = sw_find(p_ht, p_key, murmurhash(p_key, strlen(p_key), 0));
+
+    if (0 > found)
+    {
+        retval = E_NODE_NOT_FOUND;
+        goto EXIT;
+    }
+
+    const int8_t * p_group
+        = &p_ht->p_ctrl[((size_t)found / SW_GROUP_WIDTH) * SW_GROUP_WIDTH];
+
+    if (0 != sw_match(p_group, SW_CTRL_EMPTY))
+    {
+        p_ht->p_ctrl[found] = SW_CTRL_EMPTY;
+    }
+    else
+    {
+        p_ht->p_ctrl[found] = SW_CTRL_DELETED;
+        p_ht->tombstones++;
+    }
+
+    memset(&p_ht->p_slots[found], 0, sizeof(sw_slot_t));
+    p_ht->size--;
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Searches the hashtable for a key.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_key Char pointer to the key to be searched for.
+ * @return void* On success, returns a pointer to the value of the key, else
+ * NULL.
+ */
+void * sw_ht_search (sw_ht_t * p_ht, char * p_key)
+{
+    void * retval = NULL;
+
+    if (NULL == p_ht || NULL == p_key)
+    {
+        goto EXIT;
+    }
+
+    ssize_t found = sw_find(p_ht, p_key, murmurhash(p_key, strlen(p_key), 0));
+
+    if (0 <= found)
+    {
+        retval = p_ht->p_slots[found].p_value;
+    }
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that returns a bitmask of the control bytes in a
+ * group equal to tag, bit i standing for slot i of the group.
+ *
+ * @param p_group Pointer to the first control byte of the group.
+ * @param tag Control byte to look for.
+ * @return uint32_t The match bitmask.
+ */
+static uint32_t sw_match (const int8_t * p_group, int8_t tag)
+{
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_load_si128((const __m128i *)p_group);
+
+    return ((uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+#else
+    uint32_t mask = 0;
+
+    for (uint32_t idx = 0; idx < SW_GROUP_WIDTH; idx++)
+    {
+        if (tag == p_group[idx])
+        {
+            mask |= (1u << idx);
+        }
+    }
+
+    return (mask);
+#endif
+}
+
+/**
+ * @brief A private function that returns a bitmask of the empty or deleted
+ * control bytes in a group. Both have their high bit set.
+ *
+ * @param p_group Pointer to the first control byte of the group.
+ * @return uint32_t The match bitmask.
+ */
+static uint32_t sw_match_free (const int8_t * p_group)
+{
+#if defined(__SSE2__)
+    return ((uint32_t)_mm_movemask_epi8(
+        _mm_load_si128((const __m128i *)p_group)));
+#else
+    uint32_t mask = 0;
+
+    for (uint32_t idx = 0; idx < SW_GROUP_WIDTH; idx++)
+    {
+        if (0 > p_group[idx])
+        {
+            mask |= (1u << idx);
+        }
+    }
+
+    return (mask);
+#endif
+}
+
+/**
+ * @brief A private function that looks up the slot holding a key. Groups are
+ * visited in triangular order starting from the group picked by the high
+ * hash bits. Keys are only compared for slots whose 7 bit tag and cached hash
+ * both match, and the probe ends at the first group with an empty slot.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param p_key Char pointer to the key.
+ * @param hash Hash of the key.
+ * @return ssize_t Index of the slot, or -1 if the key is not present.
+ */
+static ssize_t sw_find (sw_ht_t * p_ht, char * p_key, uint32_t hash)
+{
+    size_t group_mask = (p_ht->capacity / SW_GROUP_WIDTH) - 1;
+    size_t group      = (hash >> 7) & group_mask;
+    int8_t tag        = (int8_t)(hash & 0x7f);
+
+    for (size_t step = 1; step <= group_mask + 1; step++)
+    {
+        const int8_t * p_group = &p_ht->p_ctrl[group * SW_GROUP_WIDTH];
+        uint32_t       match   = sw_match(p_group, tag);
+
+        while (0 != match)
+        {
+            size_t index = group * SW_GROUP_WIDTH + __builtin_ctz(match);
+
+            if ((hash == p_ht->p_slots[index].hash)
+                && (0 == strcmp(p_key, p_ht->p_slots[index].p_key)))
+            {
+                return ((ssize_t)index);
+            }
+
+            match &= match - 1;
+        }
+
+        if (0 != sw_match(p_group, SW_CTRL_EMPTY))
+        {
+            break;
+        }
+
+        group = (group + step) & group_mask;
+    }
+
+    return (-1);
+}
+
+/**
+ * @brief A private function that returns the first empty or deleted slot on
+ * the probe sequence of a hash. The caller guarantees one exists.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param hash Hash of the key about to be stored.
+ * @return size_t Index of the free slot.
+ */
+static size_t sw_find_free (sw_ht_t * p_ht, uint32_t hash)
+{
+    size_t group_mask = (p_ht->capacity / SW_GROUP_WIDTH) - 1;
+    size_t group      = (hash >> 7) & group_mask;
+    size_t step       = 1;
+
+    for (;;)
+    {
+        uint32_t match = sw_match_free(&p_ht->p_ctrl[group * SW_GROUP_WIDTH]);
+
+        if (0 != match)
+        {
+            return (group * SW_GROUP_WIDTH + __builtin_ctz(match));
+        }
+
+        group = (group + step) & group_mask;
+        step++;
+    }
+}
+
+/**
+ * @brief A private function that moves every entry into freshly allocated
+ * control and slot arrays of the given capacity, dropping all tombstones.
+ * Entries carry their hash, so no key is rehashed.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param new_capacity New slot count, a power of two multiple of
+ * SW_GROUP_WIDTH.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t sw_rehash (sw_ht_t * p_ht, size_t new_capacity)
+{
+    error_t     retval      = E_GENERAL;
+    int8_t *    p_new_ctrl  = aligned_alloc(SW_GROUP_WIDTH, new_capacity);
+    sw_slot_t * p_new_slots = calloc(new_capacity, sizeof(sw_slot_t));
+
+    if (NULL == p_new_ctrl || NULL == p_new_slots)
+    {
+        perror("Failed to allocate memory for hashtable slots\n");
+        free(p_new_ctrl);
+        free(p_new_slots);
+        goto EXIT;
+    }
+
+    memset(p_new_ctrl, SW_CTRL_EMPTY, new_capacity);
+
+    int8_t *    p_old_ctrl   = p_ht->p_ctrl;
+    sw_slot_t * p_old_slots  = p_ht->p_slots;
+    size_t      old_capacity = p_ht->capacity;
+
+    p_ht->p_ctrl     = p_new_ctrl;
+    p_ht->p_slots    = p_new_slots;
+    p_ht->capacity   = new_capacity;
+    p_ht->tombstones = 0;
+
+    for (size_t old_idx = 0; old_idx < old_capacity; old_idx++)
+    {
+        if (0 <= p_old_ctrl[old_idx])
+        {
+            size_t index = sw_find_free(p_ht, p_old_slots[old_idx].hash);
+
+            p_ht->p_ctrl[index]  = p_old_ctrl[old_idx];
+            p_ht->p_slots[index] = p_old_slots[old_idx];
+        }
+    }
+
+    free(p_old_ctrl);
+    free(p_old_slots);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/*** end of file ***/
@@ -0,0 +1,360 @@
+/**
+ * @file u64_hashtable.c
+ * @author Daniel Chung
+ * @brief A hashtable implementation for 64 bit integer keys using linear
+ * probing over an inline key/value array and multiplicative hashing.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/u64_hashtable.h"
+#include "../include/errorcode.h"
+
+/**
+ * @brief 2^64 / phi. Keys are mixed with a single multiply and the bucket is
+ * taken from the top bits of the product (Fibonacci hashing).
+ */
+#define U64_HT_MULTIPLIER UINT64_C(0x9E3779B97F4A7C15)
+
+/**
+ * @brief Upper bound for u64_ht_create()'s size_index, 64 << 25 slots.
+ */
+#define U64_HT_MAX_SIZE_INDEX 25
+
+static size_t  u64_home (u64_ht_t * p_ht, uint64_t key);
+static ssize_t u64_find (u64_ht_t * p_ht, uint64_t key);
+static error_t u64_grow (u64_ht_t * p_ht);
+
+/**
+ * @brief Creates a new integer keyed hashtable on heap.
+ *
+ * @param size_index The table starts with 64 << size_index slots.
+ * @return u64_ht_t* On success, returns a pointer to the newly created
+ * hashtable, else NULL.
+ */
+u64_ht_t * u64_ht_create (int size_index)
+{
+    u64_ht_t * new_ht = NULL;
+
+    if (0 > size_index || U64_HT_MAX_SIZE_INDEX < size_index)
+    {
+        goto EXIT;
+    }
+
+    new_ht = malloc(sizeof(u64_ht_t));
+
+    if (NULL == new_ht)
+    {
+        goto EXIT;
+    }
+
+    new_ht->size         = 0;
+    new_ht->capacity     = (size_t)64 << size_index;
+    new_ht->shift        = 64 - 6 - size_index;
+    new_ht->has_zero_key = 0;
+    new_ht->p_zero_value = NULL;
+    new_ht->p_slots      = calloc(new_ht->capacity, sizeof(u64_slot_t));
+
+    if (NULL == new_ht->p_slots)
+    {
+        perror("Failed to calloc memory for hashtable slots\n");
+        free(new_ht);
+        new_ht = NULL;
+        goto EXIT;
+    }
+
+EXIT:
+    return (new_ht);
+}
+
+/**
+ * @brief Destroys an integer keyed hashtable.
+ *
+ * @param p_ht Pointer to the hashtable to be destroyed.
+ * @return error_t On success, returns 0, else non zero error
+ */
+error_t u64_ht_destroy (u64_ht_t * p_ht)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    free(p_ht->p_slots);
+    free(p_ht);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Inserts a key into the hashtable, replacing the value of an existing
+ * entry for the same key.
+ *
+ * @param pp_ht A pointer to the pointer to the hashtable.
+ * @param key The key of the new entry.
+ * @param p_value Void pointer to the value of the new entry.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t u64_ht_insert (u64_ht_t ** pp_ht, uint64_t key, void * p_value)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == pp_ht || NULL == *pp_ht)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    u64_ht_t * p_ht = *pp_ht;
+
+    if (0 == key)
+    {
+        p_ht->size += !p_ht->has_zero_key;
+        p_ht->has_zero_key = 1;
+        p_ht->p_zero_value = p_value;
+        retval             = E_SUCCESS;
+        goto EXIT;
+    }
+
+    ssize_t found = u64_find(p_ht, key);
+
+    if (0 <= found)
+    {
+        p_ht->p_slots[found].p_value = p_value;
+        retval                       = E_SUCCESS;
+        goto EXIT;
+    }
+
+    // typecast to double to avoid integer division
+    if ((double)(p_ht->size + 1) / p_ht->capacity > U64_HT_MAX_LOAD)
+    {
+        retval = u64_grow(p_ht);
+
+        if ((E_SUCCESS != retval) && (p_ht->size + 1 >= p_ht->capacity))
+        {
+            retval = E_HASHTABLE_INSERT;
+            goto EXIT;
+        }
+    }
+
+    size_t index = u64_home(p_ht, key);
+
+    while (0 != p_ht->p_slots[index].key)
+    {
+        index = (index + 1) & (p_ht->capacity - 1);
+    }
+
+    p_ht->p_slots[index].key     = key;
+    p_ht->p_slots[index].p_value = p_value;
+    p_ht->size++;
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Deletes a key from the hashtable. Later entries of the same cluster
+ * that may no longer be reachable are shifted back into the hole, so no
+ * tombstones are needed.
+ *
+ * @param p_ht Pointer to the hashtable
+ * @param key The key of the entry to be deleted.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t u64_ht_delete (u64_ht_t * p_ht, uint64_t key)
+{
+    error_t retval = E_GENERAL;
+
+    if (NULL == p_ht)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    if (0 == key)
+    {
+        retval = p_ht->has_zero_key ? E_SUCCESS : E_NODE_NOT_FOUND;
+        p_ht->size -= p_ht->has_zero_key;
+        p_ht->has_zero_key = 0;
+        p_ht->p_zero_value = NULL;
+        goto EXIT;
+    }
+
+    ssize_t found = u64_find(p_ht, key);
+
+    if (0 > found)
+    {
+        retval = E_NODE_NOT_FOUND;
+        goto EXIT;
+    }
+
+    size_t mask = p_ht->capacity - 1;
+    size_t hole = (size_t)found;
+    size_t next = hole;
+
+    for (;;)
+    {
+        next = (next + 1) & mask;
+
+        if (0 == p_ht->p_slots[next].key)
+        {
+            break;
+        }
+
+        size_t home = u64_home(p_ht, p_ht->p_slots[next].key);
+
+        // move the entry back unless its home lies cyclically in (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            p_ht->p_slots[hole] = p_ht->p_slots[next];
+            hole                = next;
+        }
+    }
+
+    p_ht->p_slots[hole].key     = 0;
+    p_ht->p_slots[hole].p_value = NULL;
+    p_ht->size--;
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Searches the hashtable for a key.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param key The key to be searched for.
+ * @return void* On success, returns a pointer to the value of the key, else
+ * NULL.
+ */
+void * u64_ht_search (u64_ht_t * p_ht, uint64_t key)
+{
+    void * retval = NULL;
+
+    if (NULL == p_ht)
+    {
+        goto EXIT;
+    }
+
+    if (0 == key)
+    {
+        retval = p_ht->p_zero_value;
+        goto EXIT;
+    }
+
+    ssize_t found = u64_find(p_ht, key);
+
+    if (0 <= found)
+    {
+        retval = p_ht->p_slots[found].p_value;
+    }
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief A private function that returns the home slot of a key.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param key The key.
+ * @return size_t Index of the home slot.
+ */
+static size_t u64_home (u64_ht_t * p_ht, uint64_t key)
+{
+    return ((size_t)((key * U64_HT_MULTIPLIER) >> p_ht->shift));
+}
+
+/**
+ * @brief A private function that looks up the slot holding a non zero key.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @param key The key.
+ * @return ssize_t Index of the slot, or -1 if the key is not present.
+ */
+static ssize_t u64_find (u64_ht_t * p_ht, uint64_t key)
+{
+    size_t index = u64_home(p_ht, key);
+
+    while (0 != p_ht->p_slots[index].key)
+    {
+        if (key == p_ht->p_slots[index].key)
+        {
+            return ((ssize_t)index);
+        }
+
+        index = (index + 1) & (p_ht->capacity - 1);
+    }
+
+    return (-1);
+}
+
+/**
+ * @brief A private function that doubles the slot array and reinserts every
+ * entry.
+ *
+ * @param p_ht Pointer to the hashtable.
+ * @return error_t On success, returns 0, else non zero error.
+ */
+static error_t u64_grow (u64_ht_t * p_ht)
+{
+    error_t      retval       = E_GENERAL;
+    size_t       new_capacity = p_ht->capacity << 1;
+    u64_slot_t * p_new_slots  = NULL;
+
+    if ((size_t)64 << U64_HT_MAX_SIZE_INDEX < new_capacity)
+    {
+        goto EXIT;
+    }
+
+    p_new_slots = calloc(new_capacity, sizeof(u64_slot_t));
+
+    if (NULL == p_new_slots)
+    {
+        perror("Failed to calloc memory for hashtable slots\n");
+        goto EXIT;
+    }
+
+    u64_slot_t * p_old_slots  = p_ht->p_slots;
+    size_t       old_capacity = p_ht->capacity;
+
+    p_ht->p_slots  = p_new_slots;
+    p_ht->capacity = new_capacity;
+    p_ht->shift--;
+
+    for (size_t old_idx = 0; old_idx < old_capacity; old_idx++)
+    {
+        if (0 != p_old_slots[old_idx].key)
+        {
+            size_t index = u64_home(p_ht, p_old_slots[old_idx].key);
+
+            while (0 != p_new_slots[index].key)
+            {
+                index = (index + 1) & (new_capacity - 1);
+            }
+
+            p_new_slots[index] = p_old_slots[old_idx];
+        }
+    }
+
+    free(p_old_slots);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/*** end of file ***/
@@ -0,0 +1,215 @@
+/**
+ * @file workload.c
+ * @author Daniel Chung
+ * @brief Workload generation: a fast random number generator, deterministic
+ * key names and the uniform, zipfian and latest key distributions of YCSB.
+ * @version 0.1
+ * @date 2026-10-15
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include "../include/workload.h"
+#include "../include/errorcode.h"
+
+static uint64_t wl_zipf_next (const wl_zipf_t * p_zipf, uint64_t * p_rng);
+static uint64_t wl_scramble (uint64_t rank);
+
+/**
+ * @brief Advances a splitmix64 generator. Each thread keeps its own state.
+ *
+ * @param p_state Pointer to the generator state.
+ * @return uint64_t The next random number.
+ */
+uint64_t wl_rand (uint64_t * p_state)
+{
+    uint64_t z = (*p_state += UINT64_C(0x9E3779B97F4A7C15));
+
+    z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+
+    return (z ^ (z >> 31));
+}
+
+/**
+ * @brief Returns a random number uniformly distributed in [0, 1).
+ *
+ * @param p_state Pointer to the generator state.
+ * @return double The random number.
+ */
+double wl_rand_unit (uint64_t * p_state)
+{
+    return ((double)(wl_rand(p_state) >> 11) * 0x1.0p-53);
+}
+
+/**
+ * @brief Sets up a key generator. Zipfian constants are computed once for
+ * item_count items, which takes time linear in item_count.
+ *
+ * @param p_gen Pointer to the generator to be initialised.
+ * @param dist The key distribution.
+ * @param item_count Number of items the skew is computed over, usually the
+ * number of records loaded before the run.
+ * @param theta Skew of the zipfian distributions, in (0, 1).
+ * @return error_t On success, returns 0, else non zero error.
+ */
+error_t wl_keygen_init (wl_keygen_t * p_gen,
+                        wl_dist_t     dist,
+                        uint64_t      item_count,
+                        double        theta)
+{
+    error_t     retval = E_GENERAL;
+    wl_zipf_t * p_zipf = NULL;
+
+    if (NULL == p_gen)
+    {
+        retval = E_NULL_PTR;
+        goto EXIT;
+    }
+
+    if ((0 == item_count) || !(0 < theta && 1 > theta))
+    {
+        goto EXIT;
+    }
+
+    p_gen->dist = dist;
+    p_zipf      = &p_gen->zipf;
+    memset(p_zipf, 0, sizeof(wl_zipf_t));
+
+    if (WL_DIST_UNIFORM == dist)
+    {
+        retval = E_SUCCESS;
+        goto EXIT;
+    }
+
+    double zeta2 = 1 + pow(0.5, theta);
+
+    for (uint64_t item = 1; item <= item_count; item++)
+    {
+        p_zipf->zetan += 1 / pow((double)item, theta);
+    }
+
+    p_zipf->item_count = item_count;
+    p_zipf->theta      = theta;
+    p_zipf->alpha      = 1 / (1 - theta);
+    p_zipf->eta        = (1 - pow(2.0 / item_count, 1 - theta))
+                  / (1 - zeta2 / p_zipf->zetan);
+    retval = E_SUCCESS;
+
+EXIT:
+    return (retval);
+}
+
+/**
+ * @brief Picks the id of an existing key.
+ *
+ * @param p_gen Pointer to the key generator.
+ * @param p_rng Pointer to the caller's random number generator state.
+ * @param key_count Number of keys that exist, with ids 0 .. key_count - 1.
+ * @return uint64_t The key id.
+ */
+uint64_t wl_keygen_next (const wl_keygen_t * p_gen,
+                         uint64_t *          p_rng,
+                         uint64_t            key_count)
+{
+    uint64_t rank = 0;
+
+    if (0 == key_count)
+    {
+        return (0);
+    }
+
+    switch (p_gen->dist)
+    {
+        case WL_DIST_ZIPFIAN:
+            rank = wl_zipf_next(&p_gen->zipf, p_rng);
+            return (wl_scramble(rank) % key_count);
+        case WL_DIST_LATEST:
+            rank = wl_zipf_next(&p_gen->zipf, p_rng);
+            return ((rank < key_count) ? key_count - 1 - rank : 0);
+        case WL_DIST_UNIFORM:
+        default:
+            return (wl_rand(p_rng) % key_count);
+    }
+}
+
+/**
+ * @brief Writes the key for an id: WL_KEY_LEN_MIN base 64 digits of the id,
+ * padded with a filler character to key_len bytes and terminated. Distinct
+ * ids below 2^48 give distinct keys.
+ *
+ * @param p_key Buffer of at least key_len + 1 bytes.
+ * @param key_len Length of the key in bytes, at least WL_KEY_LEN_MIN.
+ * @param id Identifier of the key.
+ */
+void wl_make_key (char * p_key, size_t key_len, uint64_t id)
+{
+    static const char digits[]
+        = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    memset(p_key, '.', key_len);
+
+    for (size_t digit = 0; digit < WL_KEY_LEN_MIN; digit++)
+    {
+        p_key[digit] = digits[id & 63];
+        id >>= 6;
+    }
+
+    p_key[key_len] = '\0';
+}
+
+/**
+ * @brief A private function that draws a zipfian rank, 0 being the most
+ * popular item.
+ *
+ * @param p_zipf Pointer to the distribution constants.
+ * @param p_rng Pointer to the random number generator state.
+ * @return uint64_t The rank, below item_count.
+ */
+static uint64_t wl_zipf_next (const wl_zipf_t * p_zipf, uint64_t * p_rng)
+{
+    double unit  = wl_rand_unit(p_rng);
+    double scale = unit * p_zipf->zetan;
+
+    if (1 > scale)
+    {
+        return (0);
+    }
+
+    if (1 + pow(0.5, p_zipf->theta) > scale)
+    {
+        return (1);
+    }
+
+    uint64_t rank = (uint64_t)((double)p_zipf->item_count
+                               * pow(p_zipf->eta * unit - p_zipf->eta + 1,
+                                     p_zipf->alpha));
+
+    return ((rank < p_zipf->item_count) ? rank : p_zipf->item_count - 1);
+}
+
+/**
+ * @brief A private function that spreads zipfian ranks over the key space
+ * with FNV-1a, so the hot keys are not all neighbours.
+ *
+ * @param rank The rank.
+ * @return uint64_t The scrambled rank.
+ */
+static uint64_t wl_scramble (uint64_t rank)
+{
+    uint64_t hash = UINT64_C(0xCBF29CE484222325);
+
+    for (int byte = 0; byte < 8; byte++)
+    {
+        hash ^= rank & 0xFF;
+        hash *= UINT64_C(0x100000001B3);
+        rank >>= 8;
+    }
+
+    return (hash);
+}
+
+/*** end of file ***/